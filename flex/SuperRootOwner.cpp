@@ -40,6 +40,10 @@ public:
     static constexpr unsigned message_sender_is_not_my_owner = 100; ///< Authorization error
     static constexpr unsigned uninitialized                  = 101; ///< Uninitialized
     static constexpr unsigned super_root_not_deployed        = 102; ///< SuperRoot not deployed
+    static constexpr unsigned no_batch                       = 103; ///< Batch is not started
+    static constexpr unsigned batch_already_started          = 104; ///< Batch is already being collected
+    static constexpr unsigned batch_is_full                  = 105; ///< Batch has super_root_max_batch_msgs messages
+    static constexpr unsigned not_enough_evers               = 106; ///< Not enough evers for the batch
   };
 
   void constructor(
@@ -136,12 +140,55 @@ public:
   }
 
   auto impl(uint128 evers) {
+    check_owner();
+    return ISuperRootPtr(*super_root_)(Evers(evers.get()));
+  }
+
+  void check_owner() {
     require(msg_pubkey() == pubkey_, error_code::message_sender_is_not_my_owner);
     require(is_initialized(), error_code::uninitialized);
     require(!!super_root_, error_code::super_root_not_deployed);
     tvm_accept();
     tvm_commit();
-    return ISuperRootPtr(*super_root_)(Evers(evers.get()));
+  }
+
+  /// Evers for proxy message: batched messages carry their own evers, single proxy message takes all from SuperRoot
+  Evers batch_evers(uint128 main_evers) const {
+    return batch_ ? Evers(main_evers.get()) : 0_ev;
+  }
+
+  /// Send proxy message through SuperRoot or append it to the current batch
+  void proxy(uint128 main_evers, cell msg, bool cant_work, bool starting) {
+    if (batch_) {
+      check_owner();
+      require(batch_->msgs.size() < super_root_max_batch_msgs, error_code::batch_is_full);
+      batch_->msgs.push_back(msg);
+      batch_->msgs_evers += main_evers;
+      batch_->cant_work_during_update = batch_->cant_work_during_update || cant_work;
+      batch_->starting_update = batch_->starting_update || starting;
+      return;
+    }
+    impl(main_evers).proxy(msg, cant_work, starting);
+  }
+
+  void beginBatch() {
+    check_owner();
+    require(!batch_, error_code::batch_already_started);
+    batch_ = SuperRootOwnerBatch{ {}, 0u128, allowed_during_update, not_starting_update };
+  }
+
+  void sendBatch(uint128 main_evers) {
+    check_owner();
+    require(!!batch_, error_code::no_batch);
+    auto batch = *batch_;
+    require(batch.msgs_evers + uint128(batch.msgs.size() * super_root_batch_msg_fee) <= main_evers, error_code::not_enough_evers);
+    batch_.reset();
+    ISuperRootPtr(*super_root_)(Evers(main_evers.get())).proxyBatch(batch.msgs, batch.cant_work_during_update, batch.starting_update);
+  }
+
+  void cancelBatch() {
+    check_owner();
+    batch_.reset();
   }
 
   void update(
@@ -168,10 +215,9 @@ public:
     uint8   type,
     address wrapper_deployer
   ) {
-    auto sroot = impl(main_evers);
-    cell msg = IWrappersConfigPtr(wrappers_cfg).prepare_internal(0_ev).
+    cell msg = IWrappersConfigPtr(wrappers_cfg).prepare_internal(batch_evers(main_evers)).
       addWrapperType(wrappers_cfg_keep_evers, type, wrapper_deployer);
-    sroot.proxy(msg, cant_work_during_update, not_starting_update);
+    proxy(main_evers, msg, cant_work_during_update, not_starting_update);
   }
 
   void addWrapper(
@@ -183,10 +229,9 @@ public:
     uint8         type,
     cell          init_args
   ) {
-    auto sroot = impl(main_evers);
-    cell msg = IWrappersConfigPtr(wrappers_cfg).prepare_internal(0_ev).
+    cell msg = IWrappersConfigPtr(wrappers_cfg).prepare_internal(batch_evers(main_evers)).
       addWrapper(wrappers_cfg_keep_evers, evers, symbol, type, init_args);
-    sroot.proxy(msg, cant_work_during_update, not_starting_update);
+    proxy(main_evers, msg, cant_work_during_update, not_starting_update);
   }
 
   void addXchgPair(
@@ -200,11 +245,21 @@ public:
     uint128        price_denum,
     address        notify_addr
   ) {
-    auto sroot = impl(main_evers);
-    cell msg = IFlexPtr(flex).prepare_internal(0_ev).
+    cell msg = IFlexPtr(flex).prepare_internal(batch_evers(main_evers)).
       addXchgPair(evers, major_tip3cfg, minor_tip3cfg,
                   min_amount, minmove, price_denum, notify_addr);
-    sroot.proxy(msg, cant_work_during_update, not_starting_update);
+    proxy(main_evers, msg, cant_work_during_update, not_starting_update);
+  }
+
+  void addXchgPairs(
+    uint128                  main_evers,
+    address                  flex,
+    PairCloneEvers           evers,
+    dict_array<FlexPairSpec> pairs
+  ) {
+    cell msg = IFlexPtr(flex).prepare_internal(batch_evers(main_evers)).
+      addXchgPairs(evers, pairs, 0u32);
+    proxy(main_evers, msg, cant_work_during_update, not_starting_update);
   }
 
   void unlistWrapper(
@@ -212,10 +267,9 @@ public:
     address wrappers_cfg,
     address wic
   ) {
-    auto sroot = impl(main_evers);
-    cell msg = IWrappersConfigPtr(wrappers_cfg).prepare_internal(0_ev).
+    cell msg = IWrappersConfigPtr(wrappers_cfg).prepare_internal(batch_evers(main_evers)).
       unlistWrapper(wic);
-    sroot.proxy(msg, cant_work_during_update, not_starting_update);
+    proxy(main_evers, msg, cant_work_during_update, not_starting_update);
   }
 
   void unlistXchgPair(
@@ -223,20 +277,28 @@ public:
     address flex,
     address pair
   ) {
-    auto sroot = impl(main_evers);
-    cell msg = IFlexPtr(flex).prepare_internal(0_ev).
+    cell msg = IFlexPtr(flex).prepare_internal(batch_evers(main_evers)).
       unlistXchgPair(pair);
-    sroot.proxy(msg, cant_work_during_update, not_starting_update);
+    proxy(main_evers, msg, cant_work_during_update, not_starting_update);
+  }
+
+  void resumeFlexCloning(
+    uint128 main_evers,
+    address flex,
+    bool    skip_waiting
+  ) {
+    cell msg = IFlexPtr(flex).prepare_internal(batch_evers(main_evers)).
+      resumeCloning(skip_waiting);
+    proxy(main_evers, msg, allowed_during_update, not_starting_update);
   }
 
   void upgradeBroxusWrapperWallet(
     uint128 main_evers,
     address wrapper
   ) {
-    auto sroot = impl(main_evers);
-    cell msg = IWrapperBroxusPtr(wrapper).prepare_internal(0_ev).
+    cell msg = IWrapperBroxusPtr(wrapper).prepare_internal(batch_evers(main_evers)).
       upgradeExternalWallet();
-    sroot.proxy(msg, allowed_during_update, not_starting_update);
+    proxy(main_evers, msg, allowed_during_update, not_starting_update);
   }
 
   resumable<address> deployWrappersConfig(
@@ -310,6 +372,15 @@ public:
     impl(main_evers).setFlags(stop_trade, abandon_ship, update_started);
   }
 
+  void drainFlex(
+    uint128 main_evers,
+    address flex,
+    uint128 pair_evers,
+    uint128 price_evers
+  ) {
+    impl(main_evers).drainFlex(flex, pair_evers, price_evers);
+  }
+
   void transfer(
     uint128 main_evers,
     address to,
@@ -38,6 +38,14 @@ struct SuperRootOwnerDetails {
   optcell     user_id_index_code; ///< UserIdIndexCode (unsalted)
 };
 
+/// Batch of proxy messages collected by SuperRootOwner (see ISuperRootOwner::beginBatch)
+struct SuperRootOwnerBatch {
+  dict_array<cell> msgs;                    ///< Collected messages
+  uint128          msgs_evers;              ///< Sum of the collected messages evers
+  bool             cant_work_during_update; ///< At least one operation must fail if update procedure is already started
+  bool             starting_update;         ///< At least one operation starting update
+};
+
 /// Sub-component code type for setCode
 enum class sroot_code_type {
   super_root = 1,
@@ -138,6 +146,16 @@ __interface ISuperRootOwner {
     address        notify_addr      ///< Notification address (AMM)
   );
 
+  /// Add many XchgPairs at once (Flex continues with itself if they don't fit in one transaction).
+  /// Will fail if the update procedure started.
+  [[external]]
+  void addXchgPairs(
+    uint128                  main_evers, ///< Main call evers
+    address                  flex,       ///< Flex address
+    PairCloneEvers           evers,      ///< Evers configuration for each pair deploy
+    dict_array<FlexPairSpec> pairs       ///< Pairs to list
+  );
+
   /// Unlist Wrapper
   [[external]]
   void unlistWrapper(
@@ -154,6 +172,14 @@ __interface ISuperRootOwner {
     address pair        ///< XchgPair address
   );
 
+  /// Resume stalled parallel cloning of XchgPairs in the new Flex (IFlex::resumeCloning)
+  [[external]]
+  void resumeFlexCloning(
+    uint128 main_evers,  ///< Main call evers
+    address flex,        ///< New Flex address
+    bool    skip_waiting ///< Skip unanswered old pairs of the current window
+  );
+
   /// Upgrade WrapperBroxus's wallet
   [[external]]
   void upgradeBroxusWrapperWallet(
@@ -213,6 +239,15 @@ __interface ISuperRootOwner {
     opt<bool> update_started ///< Update procedures started (Wrappers/Flex/UI cloning started)
   );
 
+  /// Emergency drain of the exchange (cancel all orders). Requires `abandon_ship` flag set in SuperRoot.
+  [[external]]
+  void drainFlex(
+    uint128 main_evers, ///< Main call evers (must cover all pair_evers, they are sent in batches)
+    address flex,       ///< Flex address
+    uint128 pair_evers, ///< Evers to send to each XchgPair
+    uint128 price_evers ///< Evers to send to each active PriceXchg
+  );
+
   /// Transfer native evers from super root. Not allowed for the update team.
   [[external]]
   void transfer(
@@ -251,6 +286,25 @@ __interface ISuperRootOwner {
     address next_super_root ///< Next super root
   );
 
+  /// Start collecting a batch. Until sendBatch/cancelBatch, proxy operations (addWrapperType, addWrapper,
+  ///  addXchgPair(s), unlistWrapper, unlistXchgPair, resumeFlexCloning, upgradeBroxusWrapperWallet) are not sent
+  ///  but appended to the batch. Their `main_evers` become the evers of the batched message.
+  /// Fails if a batch is already being collected. Up to super_root_max_batch_msgs operations.
+  [[external]]
+  void beginBatch();
+
+  /// Send collected batch to SuperRoot in one proxyBatch call.
+  /// \p main_evers must cover `main_evers` of all batched operations plus super_root_batch_msg_fee for each,
+  ///  the change is returned by SuperRoot.
+  [[external]]
+  void sendBatch(
+    uint128 main_evers ///< Main call evers
+  );
+
+  /// Drop collected batch
+  [[external]]
+  void cancelBatch();
+
   /// Get contract details
   [[getter]]
   SuperRootOwnerDetails getDetails();
@@ -273,6 +327,7 @@ struct DSuperRootOwner {
   optcell     flex_client_code_;   ///< FlexClient code (unsalted)
   optcell     auth_index_code_;    ///< AuthIndex code (unsalted)
   optcell     user_id_index_code_; ///< UserIdIndexCode (unsalted)
+  opt<SuperRootOwnerBatch> batch_; ///< Batch of proxy messages being collected
 };
 
 /// \interface ESuperRootOwner
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "Tip3TransferCosts.hpp"
+
 namespace tvm {
 
 /// Processing native funds value ...
@@ -25,4 +27,36 @@ struct EversConfig {
   uint128 dest_wallet_keep_evers;
 };
 
+/// Minimum evers for order processing in PriceXchg::onTip3LendOwnership.
+/// We need funds for processing:
+/// * execute onTip3LendOwnership / processQueue
+/// * execute transfer from seller's tip3 wallet to buyer tip3 wallet
+/// * execute transfer from buyer's tip3 wallet to seller tip3 wallet
+/// * execute transfer from taker's tip3 wallet to reserve tip3 wallet
+/// * send notification (IFlexNotify)
+/// * send registration of the price in XchgPair (the first order of an empty PriceXchg)
+/// * execute returnOwnership of tip3 wallet to return ownership to the original owner
+/// * send answer message
+__always_inline
+uint128 calc_order_min_value(EversConfig ev_cfg) {
+  return ev_cfg.process_queue + 3 * ev_cfg.transfer_tip3 + 2 * ev_cfg.send_notify +
+    ev_cfg.return_ownership + ev_cfg.order_answer;
+}
+
+/// Minimum evers for a tip3 transfer accepted by FlexWallet (the same check as in TONTokenWallet).
+/// PriceXchg sends deal transfers with `transfer_tip3` evers, so smaller values fail every deal.
+static constexpr unsigned evers_cfg_min_transfer_tip3 = tip3_min_transfer_costs;
+
+/// Check EversConfig lower bounds, which are known without execution:
+/// * `transfer_tip3` must pass FlexWallet minimum transfer costs check
+/// * `dest_wallet_keep_evers` is kept by destination wallet from the transfer value, so it must be less
+/// * other processing values must be non-zero
+__always_inline
+bool is_valid_evers_config(EversConfig ev_cfg) {
+  return ev_cfg.transfer_tip3 >= evers_cfg_min_transfer_tip3 &&
+    ev_cfg.dest_wallet_keep_evers < ev_cfg.transfer_tip3 &&
+    ev_cfg.return_ownership > 0 && ev_cfg.order_answer > 0 &&
+    ev_cfg.process_queue > 0 && ev_cfg.send_notify > 0;
+}
+
 } // namespace tvm
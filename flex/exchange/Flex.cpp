@@ -44,8 +44,22 @@ public:
     static constexpr unsigned sender_is_not_my_owner        = 100; ///< Sender is not my owner
     static constexpr unsigned uninitialized                 = 101; ///< Uninitialized
     static constexpr unsigned incorrect_config              = 102; ///< Incorrect config
+    static constexpr unsigned pair_already_listed           = 103; ///< Pair with these tip3 roots is already listed
+    static constexpr unsigned pair_not_found                = 104; ///< Pair is not found in the registry
+    static constexpr unsigned unexpected_clone_answer       = 105; ///< Unexpected answer during parallel cloning
+    static constexpr unsigned not_cloning                   = 106; ///< Parallel cloning is not in progress
+    static constexpr unsigned too_many_pairs                = 107; ///< Too many pairs in one addXchgPairs call
   };
 
+  /// Out actions limit of a transaction (reserve and the continuation or change message take two)
+  static constexpr unsigned max_out_actions = 255;
+  /// Pairs deployed in one addXchgPairs transaction (deploy and setNext messages per pair)
+  static constexpr unsigned pairs_per_transaction = (max_out_actions - 2) / 2;
+  /// Pairs in one addXchgPairs call, the whole list is validated in the first transaction
+  static constexpr unsigned max_pairs_per_call = 2 * pairs_per_transaction;
+  /// Pairs requested to drain in one drain transaction (one message per pair)
+  static constexpr unsigned drain_pairs_per_transaction = max_out_actions - 2;
+
   resumable<void> onDeploy(
     uint128        flex_keep_evers,
     PairCloneEvers evers,
@@ -67,6 +81,15 @@ public:
     if (!old_flex)
       co_return;
 
+    if constexpr (FLEX_CLONE_WINDOW > 0) {
+      // Parallel cloning: up to FLEX_CLONE_WINDOW old pairs in flight, see onClonePage
+      old_flex_ = old_flex;
+      clone_evers_ = evers;
+      clone_cursor_ = 0u32;
+      request_clone_page();
+      co_return;
+    }
+
     // If we are cloning from previous Flex:
     //  * Requesting first/last pairs in linked list from previous Flex
     //  * For each old pair in the list:
@@ -90,46 +113,32 @@ public:
           major_tip3cfg_ = details.major_tip3cfg;
           minor_tip3cfg_ = details.minor_tip3cfg;
 
-          IWrapperPtr major_wrapper(major_tip3cfg_->root_address);
-          auto [cloned_major_root, cloned_major_pubkey] = co_await major_wrapper(_all_except(flex_keep_evers)).cloned();
-          if (cloned_major_root) {
-            major_tip3cfg_->root_address = *cloned_major_root;
-            major_tip3cfg_->root_pubkey = cloned_major_pubkey;
+          // Each old wrapper is asked only once per upgrade, answers are memoized in clone_roots_
+          auto major_old_root = major_tip3cfg_->root_address;
+          if (!clone_roots_.contains(major_old_root)) {
+            auto [cloned_major_root, cloned_major_pubkey] =
+              co_await IWrapperPtr(major_old_root)(_all_except(flex_keep_evers)).cloned();
+            clone_roots_.set_at(major_old_root, FlexClonedRoot{cloned_major_root, cloned_major_pubkey});
           }
+          apply_cloned_root(*major_tip3cfg_, **clone_roots_.lookup(major_old_root));
 
-          IWrapperPtr minor_wrapper(minor_tip3cfg_->root_address);
-          auto [cloned_minor_root, cloned_minor_pubkey] = co_await minor_wrapper(_all_except(flex_keep_evers)).cloned();
-          if (cloned_minor_root) {
-            minor_tip3cfg_->root_address = *cloned_minor_root;
-            major_tip3cfg_->root_pubkey = cloned_minor_pubkey;
+          auto minor_old_root = minor_tip3cfg_->root_address;
+          if (!clone_roots_.contains(minor_old_root)) {
+            auto [cloned_minor_root, cloned_minor_pubkey] =
+              co_await IWrapperPtr(minor_old_root)(_all_except(flex_keep_evers)).cloned();
+            clone_roots_.set_at(minor_old_root, FlexClonedRoot{cloned_minor_root, cloned_minor_pubkey});
           }
+          apply_cloned_root(*minor_tip3cfg_, **clone_roots_.lookup(minor_old_root));
 
-          auto [init, hash] = prepare<IXchgPair>(
-            prepare_pair(major_tip3cfg_->root_address, minor_tip3cfg_->root_address),
-            xchg_pair_code_.get()
-          );
-
-          IXchgPairPtr clone_ptr(address::make_std(workchain_id_, hash));
-          clone_ptr.deploy(init, Evers(evers.deploy.get())).onDeploy(
-            min_amount_, minmove_, price_denum_,
-            evers.pair_keep,
-            *notify_addr_, *major_tip3cfg_, *minor_tip3cfg_
-          );
-          last_pair_ = clone_ptr.get();
-          if (!first_pair_)
-            first_pair_ = last_pair_;
-          if (prev_clone_)
-            IXchgPairPtr(*prev_clone_)(Evers(evers.setnext.get())).setNext(clone_ptr.get());
-          prev_clone_ = clone_ptr.get();
-          ++pairs_count_;
+          deploy_pair(evers, min_amount_, minmove_, price_denum_, *notify_addr_, *major_tip3cfg_, *minor_tip3cfg_);
         }
 
         it_ = next_;
       }
     }
-    prev_clone_.reset();
     next_.reset();
     notify_addr_.reset();
+    clone_roots_ = {};
     major_tip3cfg_.reset();
     minor_tip3cfg_.reset();
     co_return;
@@ -148,37 +157,77 @@ public:
     require(min_amount > 0 && minmove > 0 && price_denum > 0, error_code::incorrect_config);
     require(int_sender() == cfg.super_root, error_code::sender_is_not_my_owner);
     require(xchg_pair_code_, error_code::uninitialized);
+    require(!pair_ids_.contains(getXchgTradingPair(major_tip3cfg.root_address, minor_tip3cfg.root_address)),
+            error_code::pair_already_listed);
 
     tvm_rawreserve(tvm_balance() - int_value().get(), rawreserve_flag::up_to);
 
-    auto pair_data = prepare_pair(major_tip3cfg.root_address, minor_tip3cfg.root_address);
-    auto [init, hash] = prepare<IXchgPair>(pair_data, xchg_pair_code_.get());
-    IXchgPairPtr ptr(address::make_std(workchain_id_, hash));
-    if (!last_pair_) {
-      ptr.deploy(init, Evers(evers.deploy.get())).onDeploy(
-        min_amount, minmove, price_denum,
-        evers.pair_keep,
-        notify_addr, major_tip3cfg, minor_tip3cfg
-      );
-      first_pair_ = ptr.get();
-      last_pair_ = ptr.get();
-      pairs_count_ = 1;
-    } else {
-      ptr.deploy(init, Evers(evers.deploy.get())).onDeploy(
-        min_amount, minmove, price_denum,
-        evers.pair_keep,
-        notify_addr, major_tip3cfg, minor_tip3cfg
-      );
-      IXchgPairPtr(*last_pair_)(Evers(evers.setnext.get())).setNext(ptr.get());
-      last_pair_ = ptr.get();
-      ++pairs_count_;
-    }
+    auto pair = deploy_pair(evers, min_amount, minmove, price_denum, notify_addr, major_tip3cfg, minor_tip3cfg);
     set_int_return_flag(SEND_ALL_GAS);
-    return ptr.get();
+    return pair;
+  }
+
+  void addXchgPairs(
+    PairCloneEvers           evers,
+    dict_array<FlexPairSpec> pairs,
+    uint32                   start
+  ) {
+    auto cfg = getConfig();
+    // Continuation calls (start != 0) are sent only by Flex itself, with the list validated in the first call
+    require(start == 0 ? int_sender() == cfg.super_root : int_sender() == tvm_myaddr(),
+            error_code::sender_is_not_my_owner);
+    require(xchg_pair_code_, error_code::uninitialized);
+    // The whole list is validated before listing anything
+    if (start == 0)
+      check_pair_specs(pairs);
+
+    tvm_rawreserve(tvm_balance() - int_value().get(), rawreserve_flag::up_to);
+
+    unsigned end = std::min<unsigned>(pairs.size(), start.get() + pairs_per_transaction);
+    for (unsigned i = start.get(); i < end; ++i) {
+      auto spec = pairs.get_at(i);
+      // May be listed by addXchgPair between the continuation transactions
+      if (pair_ids_.contains(getXchgTradingPair(spec.major_tip3cfg.root_address, spec.minor_tip3cfg.root_address)))
+        continue;
+      deploy_pair(evers, spec.min_amount, spec.minmove, spec.price_denum, spec.notify_addr,
+                  spec.major_tip3cfg, spec.minor_tip3cfg);
+    }
+    if (end < pairs.size())
+      IFlexPtr(tvm_myaddr())(0_ev, SEND_ALL_GAS).addXchgPairs(evers, pairs, uint32(end));
+    else
+      tvm_transfer(cfg.super_root, 0, false, SEND_ALL_GAS);
+  }
+
+  void drain(
+    uint128 pair_evers,
+    uint128 price_evers,
+    uint32  start
+  ) {
+    auto cfg = getConfig();
+    // Continuation calls are sent by Flex itself
+    require(int_sender() == cfg.super_root || int_sender() == tvm_myaddr(), error_code::sender_is_not_my_owner);
+
+    tvm_rawreserve(tvm_balance() - int_value().get(), rawreserve_flag::up_to);
+
+    unsigned end = std::min<unsigned>(next_pair_id_.get(), start.get() + drain_pairs_per_transaction);
+    for (unsigned id = start.get(); id < end; ++id) {
+      if (auto rec = pairs_.lookup(id))
+        IXchgPairPtr(rec->pair)(Evers(pair_evers.get())).drain(price_evers);
+    }
+    drained_pairs_ = end;
+    if (end < next_pair_id_.get())
+      IFlexPtr(tvm_myaddr())(0_ev, SEND_ALL_GAS).drain(pair_evers, price_evers, uint32(end));
+    else
+      tvm_transfer(cfg.super_root, 0, false, SEND_ALL_GAS);
   }
 
   void unlistXchgPair(address pair) {
     check_owner();
+    auto id = pair_ids_.extract(pair);
+    require(!!id, error_code::pair_not_found);
+    // Tombstone: the id is not reused, so getPairs cursors stay valid
+    pairs_.erase(*id);
+    --pairs_count_;
     IXchgPairPtr(pair)(_remaining_ev()).unlist();
   }
 
@@ -186,6 +235,87 @@ public:
     return _remaining_ev() & PairsRange{ first_pair_, last_pair_ };
   }
 
+  FlexPairsPage requestPairsPage(uint32 cursor, uint32 limit) {
+    return _remaining_ev() & getPairs(cursor, limit);
+  }
+
+  void onClonePage(FlexPairsPage page) {
+    require(old_flex_ && int_sender() == *old_flex_ && clone_page_pending_.get(), error_code::unexpected_clone_answer);
+    clone_page_pending_ = false;
+    clone_cursor_ = page.next_cursor;
+    if (page.pairs.empty()) {
+      // The page may consist of unlisted ids only
+      finish_window();
+      return;
+    }
+    // Requesting details from all old pairs of the window at once
+    unsigned idx = 0;
+    for (auto rec : page.pairs) {
+      clone_pairs_.set_at(rec.pair, {uint32(idx++), {}});
+      ++clones_in_flight_;
+      request_clone_details(rec.pair);
+    }
+  }
+
+  void onCloneDetails(XchgPairDetails details) {
+    auto sender = int_sender();
+    auto waiting = clone_pairs_.lookup(sender);
+    require(waiting && !waiting->details, error_code::unexpected_clone_answer);
+    if (details.unlisted) {
+      clone_pairs_.erase(sender);
+      on_clone_done();
+      return;
+    }
+    FlexClonePair pair { waiting->idx, details };
+    clone_pairs_.set_at(sender, pair);
+    // Each old wrapper is asked only once per upgrade, pairs with the same roots are waiting for one answer
+    request_cloned_root(details.major_tip3cfg.root_address);
+    request_cloned_root(details.minor_tip3cfg.root_address);
+    try_clone(sender, pair);
+  }
+
+  void onCloneWrapper(address_opt cloned, uint256 cloned_pubkey) {
+    auto sender = int_sender();
+    auto waiting = clone_roots_.lookup(sender);
+    require(waiting && !*waiting, error_code::unexpected_clone_answer);
+    clone_roots_.set_at(sender, FlexClonedRoot{cloned, cloned_pubkey});
+    // Only old pairs of the current window are in clone_pairs_ (at most FLEX_CLONE_WINDOW).
+    // try_clone erases the cloned pair, erasing the current key doesn't break the dict iteration.
+    for (auto [old_pair, pair] : clone_pairs_) {
+      if (pair.details && (pair.details->major_tip3cfg.root_address == sender ||
+                           pair.details->minor_tip3cfg.root_address == sender))
+        try_clone(old_pair, pair);
+    }
+  }
+
+  void resumeCloning(bool skip_waiting) {
+    check_owner();
+    require(!!old_flex_, error_code::not_cloning);
+    if (skip_waiting) {
+      clone_pairs_ = {};
+      clones_in_flight_ = 0;
+      // Unanswered wrappers will be asked again by the next windows
+      for (auto [old_root, cloned] : clone_roots_) {
+        if (!cloned)
+          clone_roots_.erase(old_root);
+      }
+      finish_window();
+      return;
+    }
+    if (clone_page_pending_.get()) {
+      request_clone_page();
+      return;
+    }
+    for (auto [old_pair, pair] : clone_pairs_) {
+      if (!pair.details)
+        request_clone_details(old_pair);
+    }
+    for (auto [old_root, cloned] : clone_roots_) {
+      if (!cloned)
+        send_cloned_request(old_root);
+    }
+  }
+
   FlexSalt getConfig() {
     return parse_chain_static<FlexSalt>(parser(tvm_code_salt()));
   }
@@ -195,7 +325,7 @@ public:
     return {
       xchg_pair_code_.get(),
       uint256{tvm_hash(getConfig().xchg_price_code)},
-      first_pair_, last_pair_, pairs_count_
+      first_pair_, last_pair_, pairs_count_, drained_pairs_
       };
   }
 
@@ -209,10 +339,177 @@ public:
     return calc_lend_tokens_for_order(sell, major_tokens, price);
   }
 
+  FlexPairsPage getPairs(uint32 cursor, uint32 limit) {
+    FlexPairsPage page;
+    // Clamped to [cursor, next_pair_id_), so cursor + limit can't overflow
+    unsigned first = std::min<unsigned>(cursor.get(), next_pair_id_.get());
+    unsigned end = first + std::min<unsigned>(limit.get(), next_pair_id_.get() - first);
+    for (unsigned id = first; id < end; ++id) {
+      if (auto rec = pairs_.lookup(id))
+        page.pairs.push_back(*rec);
+    }
+    if (end < next_pair_id_.get())
+      page.next_cursor = uint32(end);
+    return page;
+  }
+
   void check_owner() {
     require(int_sender() == getConfig().super_root, error_code::sender_is_not_my_owner);
   }
 
+  /// Deploy pair (or clone of the old pair) and link it to the end of the list
+  address deploy_pair(
+    PairCloneEvers evers,
+    uint128        min_amount,
+    uint128        minmove,
+    uint128        price_denum,
+    address        notify_addr,
+    Tip3Config     major_tip3cfg,
+    Tip3Config     minor_tip3cfg
+  ) {
+    auto pair = deploy_pair_contract(evers, min_amount, minmove, price_denum, notify_addr, major_tip3cfg, minor_tip3cfg);
+    link_pair(evers, pair, major_tip3cfg.root_address, minor_tip3cfg.root_address);
+    return pair;
+  }
+
+  /// Deploy pair (or clone of the old pair) without linking
+  address deploy_pair_contract(
+    PairCloneEvers evers,
+    uint128        min_amount,
+    uint128        minmove,
+    uint128        price_denum,
+    address        notify_addr,
+    Tip3Config     major_tip3cfg,
+    Tip3Config     minor_tip3cfg
+  ) {
+    auto [init, hash] = prepare<IXchgPair>(
+      prepare_pair(major_tip3cfg.root_address, minor_tip3cfg.root_address),
+      xchg_pair_code_.get()
+    );
+    IXchgPairPtr ptr(address::make_std(workchain_id_, hash));
+    ptr.deploy(init, Evers(evers.deploy.get())).onDeploy(
+      min_amount, minmove, price_denum,
+      evers.pair_keep,
+      notify_addr, major_tip3cfg, minor_tip3cfg
+    );
+    return ptr.get();
+  }
+
+  /// Link deployed pair to the end of the list and register it
+  void link_pair(PairCloneEvers evers, address pair, address major_root, address minor_root) {
+    if (last_pair_)
+      IXchgPairPtr(*last_pair_)(Evers(evers.setnext.get())).setNext(pair);
+    else
+      first_pair_ = pair;
+    last_pair_ = pair;
+    register_pair(pair, major_root, minor_root);
+  }
+
+  /// Parallel cloning: request the next window of old pairs from the old Flex
+  void request_clone_page() {
+    clone_page_pending_ = true;
+    // performing `tail call` - requesting old Flex to answer into onClonePage
+    temporary_data::setglob(global_id::answer_id, id_v<&IFlex::onClonePage>);
+    IFlexPtr(*old_flex_)(Evers(clone_evers_->setnext.get())).
+      requestPairsPage(*clone_cursor_, uint32(FLEX_CLONE_WINDOW));
+  }
+
+  /// Parallel cloning: request details of the old pair
+  void request_clone_details(address old_pair) {
+    // performing `tail call` - requesting old pair to answer into onCloneDetails
+    temporary_data::setglob(global_id::answer_id, id_v<&IFlex::onCloneDetails>);
+    IXchgPairPtr(old_pair)(Evers(clone_evers_->setnext.get())).requestDetails();
+  }
+
+  /// Parallel cloning: request IWrapper::cloned() if this old wrapper was not asked yet
+  void request_cloned_root(address old_root) {
+    if (clone_roots_.contains(old_root))
+      return;
+    clone_roots_.set_at(old_root, {});
+    send_cloned_request(old_root);
+  }
+
+  /// Parallel cloning: request IWrapper::cloned() from the old wrapper
+  void send_cloned_request(address old_root) {
+    // performing `tail call` - requesting old wrapper to answer into onCloneWrapper
+    temporary_data::setglob(global_id::answer_id, id_v<&IFlex::onCloneWrapper>);
+    IWrapperPtr(old_root)(Evers(clone_evers_->setnext.get())).cloned();
+  }
+
+  /// Parallel cloning: deploy clone if both wrappers are already resolved.
+  /// The clone is linked at the window end, in the old pairs order.
+  void try_clone(address old_pair, FlexClonePair pair) {
+    auto details = *pair.details;
+    auto major = clone_roots_.lookup(details.major_tip3cfg.root_address);
+    auto minor = clone_roots_.lookup(details.minor_tip3cfg.root_address);
+    if (!major || !*major || !minor || !*minor)
+      return;
+    apply_cloned_root(details.major_tip3cfg, **major);
+    apply_cloned_root(details.minor_tip3cfg, **minor);
+    auto clone = deploy_pair_contract(*clone_evers_, details.min_amount, details.minmove, details.price_denum,
+                                      details.notify_addr, details.major_tip3cfg, details.minor_tip3cfg);
+    clone_done_.set_at(pair.idx, {clone, details.major_tip3cfg.root_address, details.minor_tip3cfg.root_address});
+    clone_pairs_.erase(old_pair);
+    on_clone_done();
+  }
+
+  /// Replace root address and pubkey in tip3 config if the wrapper is cloned
+  static void apply_cloned_root(Tip3Config &cfg, FlexClonedRoot cloned) {
+    if (cloned.root) {
+      cfg.root_address = *cloned.root;
+      cfg.root_pubkey = cloned.pubkey;
+    }
+  }
+
+  /// Parallel cloning: one old pair of the window is processed
+  void on_clone_done() {
+    if (--clones_in_flight_ > 0)
+      return;
+    finish_window();
+  }
+
+  /// Parallel cloning: link clones of the window in the old pairs order and continue with the next window
+  void finish_window() {
+    for (auto [idx, rec] : clone_done_)
+      link_pair(*clone_evers_, rec.pair, rec.major_root, rec.minor_root);
+    clone_done_ = {};
+    if (clone_cursor_)
+      request_clone_page();
+    else
+      finish_cloning();
+  }
+
+  /// Parallel cloning: all old pairs are processed
+  void finish_cloning() {
+    old_flex_.reset();
+    clone_evers_.reset();
+    clone_cursor_.reset();
+    clone_pairs_ = {};
+    clone_done_ = {};
+    clone_roots_ = {};
+  }
+
+  /// Check bulk listing specs: correct configs, no pairs listed already or repeated in the list
+  void check_pair_specs(dict_array<FlexPairSpec> pairs) {
+    require(pairs.size() <= max_pairs_per_call, error_code::too_many_pairs);
+    small_dict_map<addr_std_fixed, bool_t> seen;
+    for (unsigned i = 0; i < pairs.size(); ++i) {
+      auto spec = pairs.get_at(i);
+      require(spec.min_amount > 0 && spec.minmove > 0 && spec.price_denum > 0, error_code::incorrect_config);
+      address pair = getXchgTradingPair(spec.major_tip3cfg.root_address, spec.minor_tip3cfg.root_address);
+      require(!pair_ids_.contains(pair) && !seen.contains(pair), error_code::pair_already_listed);
+      seen.set_at(pair, true);
+    }
+  }
+
+  /// Add pair into registry with the next sequential id
+  void register_pair(address pair, address major_root, address minor_root) {
+    pairs_.set_at(next_pair_id_, {pair, major_root, minor_root});
+    pair_ids_.set_at(pair, next_pair_id_);
+    ++next_pair_id_;
+    ++pairs_count_;
+  }
+
   // default processing of unknown messages
   static int _fallback([[maybe_unused]] cell msg, [[maybe_unused]] slice msg_body) {
     return 0;
@@ -10,6 +10,7 @@
 #include <tvm/smart_switcher.hpp>
 #include <tvm/contract_handle.hpp>
 #include <tvm/replay_attack_protection/timestamp.hpp>
+#include <tvm/small_dict_map.hpp>
 #include "PriceCommon.hpp"
 #include "FlexWallet.hpp"
 #include "EversConfig.hpp"
@@ -75,7 +76,8 @@ struct FlexDetails {
   uint256     unsalted_price_code_hash; ///< PriceXchg code hash (unsalted)
   address_opt first_pair;               ///< First XchgPair in linked list
   address_opt last_pair;                ///< Last XchgPair in linked list
-  uint32      pairs_count;              ///< Count of XchgPair contracts
+  uint32      pairs_count;              ///< Count of listed XchgPair contracts
+  uint32      drained_pairs;            ///< Pairs requested to drain (emergency drain progress)
 };
 
 /// Flex pairs list
@@ -84,6 +86,48 @@ struct PairsRange {
   address_opt last_pair;                ///< Last XchgPair in linked list
 };
 
+/// Pair registry record
+struct FlexPairRecord {
+  address pair;       ///< XchgPair address
+  address major_root; ///< Address of the major tip3 root (Wrapper)
+  address minor_root; ///< Address of the minor tip3 root (Wrapper)
+};
+
+/// Page of listed pairs (for getter)
+struct FlexPairsPage {
+  dict_array<FlexPairRecord> pairs;       ///< Listed pairs with ids in [cursor, next_cursor)
+  opt<uint32>                next_cursor; ///< Cursor for the next page (empty if this is the last page)
+};
+
+/// Pair listing specification for bulk listing (addXchgPairs)
+struct FlexPairSpec {
+  Tip3Config major_tip3cfg; ///< Major tip3 configuration
+  Tip3Config minor_tip3cfg; ///< Minor tip3 configuration
+  uint128    min_amount;    ///< Minimum amount of major tokens for a deal or an order
+  uint128    minmove;       ///< Minimum move for price
+  uint128    price_denum;   ///< Price denominator for the pair
+  address    notify_addr;   ///< Notification address (AMM)
+};
+
+/// Answer of IWrapper::cloned() stored during parallel cloning
+struct FlexClonedRoot {
+  address_opt root;   ///< Cloned wrapper address (empty if the wrapper is not cloned)
+  uint256     pubkey; ///< Cloned wrapper public key
+};
+
+/// Old pair in flight during parallel cloning
+struct FlexClonePair {
+  uint32               idx;     ///< Position in the current window (clones are linked in this order)
+  opt<XchgPairDetails> details; ///< Old pair details (when received)
+};
+
+/// Parallel cloning window (pairs in flight during Flex upgrade). 0 means serial cloning.
+/// Not enabled in the shipped Flex.tvc: the old Flex must implement requestPairsPage,
+///  so it may be enabled (-DFLEX_CLONE_WINDOW=N in exchange/Makefile) only for an upgrade from this version.
+#ifndef FLEX_CLONE_WINDOW
+#define FLEX_CLONE_WINDOW 0
+#endif
+
 /** \interface IFlex
  *  \brief Flex root contract interface.
  *  Flex is a root contract for exchange system.
@@ -110,7 +154,19 @@ __interface IFlex {
     address    notify_addr      ///< Notification address (AMM)
     ) = immutable_ids::flex_register_xchg_pair_id;
 
-  /// Unlist tip3/tip3 xchg pair
+  /// Register many tip3/tip3 xchg pairs.
+  /// Pairs are deployed and chained in the list order.
+  /// The first call validates the whole list and fails if any pair is incorrect, already listed or repeated.
+  /// If the pairs don't fit into one transaction, Flex continues from \p start with a call to itself
+  ///  (pairs listed by addXchgPair in between are skipped).
+  [[internal]]
+  void addXchgPairs(
+    PairCloneEvers           evers, ///< Evers configuration for each pair deploy
+    dict_array<FlexPairSpec> pairs, ///< Pairs to list
+    uint32                   start  ///< First pair to process (must be 0, other values are accepted only from Flex itself)
+  ) = 28;
+
+  /// Unlist tip3/tip3 xchg pair (and remove it from the registry)
   [[internal]]
   void unlistXchgPair(
     address pair ///< XchgPair address
@@ -119,6 +175,42 @@ __interface IFlex {
   /// Request first/last pair in list
   [[internal, answer_id]]
   PairsRange requestPairs() = immutable_ids::flex_request_pairs_id;
+
+  /// Request page of listed pairs from registry (the same as getPairs, for parallel cloning by the next Flex)
+  [[internal, answer_id]]
+  FlexPairsPage requestPairsPage(
+    uint32 cursor, ///< First pair id in the page
+    uint32 limit   ///< Maximum pairs in the page
+  ) = immutable_ids::flex_request_pairs_page_id;
+
+  /// Parallel cloning: page of old pairs from the old Flex (answer to requestPairsPage)
+  [[internal]]
+  void onClonePage(FlexPairsPage page) = 25;
+
+  /// Parallel cloning: old pair details (answer to IXchgPair::requestDetails)
+  [[internal]]
+  void onCloneDetails(XchgPairDetails details) = 26;
+
+  /// Parallel cloning: wrapper clone info (answer to IWrapper::cloned)
+  [[internal]]
+  void onCloneWrapper(address_opt cloned, uint256 cloned_pubkey) = 27;
+
+  /// Parallel cloning: resume stalled cloning (an answer was lost or bounced).
+  /// Requests are sent again for all unanswered old pairs, wrappers and the current page.
+  /// With \p skip_waiting, unanswered old pairs of the current window are skipped (not cloned)
+  ///  and cloning continues with the next window. Skipped pairs may be listed again by addXchgPair.
+  [[internal]]
+  void resumeCloning(bool skip_waiting) = 30;
+
+  /// Emergency drain: request all listed pairs to drain their PriceXchg contracts (IXchgPair::drain).
+  /// Requested by SuperRoot when `abandon_ship` flag is set.
+  /// If the pairs don't fit into one transaction, Flex continues from \p start with a call to itself.
+  [[internal]]
+  void drain(
+    uint128 pair_evers,  ///< Evers to send in each IXchgPair::drain call
+    uint128 price_evers, ///< Evers to send in each IPriceXchg::drain call
+    uint32  start        ///< First pair id to process (0 for the external call)
+  ) = 29;
   // ========== getters ==========
 
   /// Get Flex configuration from code salt
@@ -136,6 +228,15 @@ __interface IFlex {
   /// Calculate necessary lend tokens for order
   [[getter]]
   uint128 calcLendTokensForOrder(bool sell, uint128 major_tokens, price_t price) = 23;
+
+  /// Get page of listed pairs from registry.
+  /// Pair ids are stable: a listed pair keeps its id, an unlisted pair leaves a hole (tombstone).
+  /// The page covers at most \p limit ids, so it may contain less than \p limit pairs.
+  [[getter]]
+  FlexPairsPage getPairs(
+    uint32 cursor, ///< First pair id in the page
+    uint32 limit   ///< Maximum pair ids in the page
+  ) = 24;
 };
 using IFlexPtr = handle<IFlex>;
 
@@ -147,10 +248,12 @@ struct DFlex {
   optcell       xchg_pair_code_;  ///< XchgPair code (with salt added)
   address_opt   first_pair_;      ///< First XchgPair in linked list
   address_opt   last_pair_;       ///< Last XchgPair in linked list
-  uint32        pairs_count_;     ///< Count of XchgPair contracts
+  uint32        pairs_count_;     ///< Count of listed XchgPair contracts
+  uint32        next_pair_id_;    ///< Id for the next listed pair (ids are never reused)
+  small_dict_map<uint32, FlexPairRecord> pairs_;   ///< Registry of listed pairs by id (unlisted ids are erased)
+  small_dict_map<addr_std_fixed, uint32> pair_ids_; ///< Pair id by XchgPair address (address is defined by the roots)
   uint128       flex_keep_evers_; ///< Evers to keep in the contract
   address_opt   it_;              ///< Old pair iterator (for cloning)
-  address_opt   prev_clone_;      ///< Previous pair clone (for cloning)
   address_opt   next_;            ///< Next XchgPair address (for cloning)
   address_opt   notify_addr_;     ///< Notification address (AMM) (for cloning)
   uint128       min_amount_;      ///< Minimum amount of major tokens for a deal or an order
@@ -158,6 +261,16 @@ struct DFlex {
   uint128       price_denum_;     ///< Price denominator for the pair
   opt<Tip3Config> major_tip3cfg_; ///< Configuration of the major tip3 token for current pair (for cloning)
   opt<Tip3Config> minor_tip3cfg_; ///< Configuration of the minor tip3 token for current pair (for cloning)
+  address_opt     old_flex_;       ///< Old Flex to clone pairs from (for parallel cloning)
+  opt<PairCloneEvers> clone_evers_; ///< Evers configuration for each pair cloning (for parallel cloning)
+  opt<uint32>     clone_cursor_;   ///< Next page cursor in the old Flex registry (for parallel cloning)
+  bool_t          clone_page_pending_; ///< Page of old pairs is requested and not received yet (for parallel cloning)
+  uint32          clones_in_flight_; ///< Old pairs of the current window not cloned yet (for parallel cloning)
+  small_dict_map<addr_std_fixed, FlexClonePair> clone_pairs_; ///< Old pairs in flight of the current window
+  small_dict_map<uint32, FlexPairRecord> clone_done_; ///< Clones of the current window by position (linked at window end)
+  small_dict_map<addr_std_fixed, opt<FlexClonedRoot>>  clone_roots_; ///< Old wrapper -> cloned() answer (when received),
+                                                                     ///<  each wrapper is asked once per upgrade (for cloning)
+  uint32          drained_pairs_;  ///< Pair ids requested to drain (emergency drain progress)
 };
 
 /// \interface EFlex
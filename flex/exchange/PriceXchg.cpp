@@ -16,6 +16,7 @@
 
 #include "xchg/dealer.hpp"
 #include "xchg/orders_queue.hpp"
+#include "gas_profile.hpp"
 
 using namespace tvm;
 using namespace xchg;
@@ -29,6 +30,8 @@ using namespace xchg;
 #endif
 
 static constexpr unsigned c_msgs_limit = 200; ///< Messages limit in process_queue for one transaction
+static constexpr unsigned c_estimate_continuations_limit = 16; ///< Maximum processQueue continuations simulated in estimateOrder
+static constexpr unsigned c_drain_orders_limit = 100; ///< Orders canceled in one drain transaction
 
 __attribute__((noinline))
 auto process_queue_impl(price_t price, address pair, Tip3Config major_tip3cfg, Tip3Config minor_tip3cfg, EversConfig ev_cfg,
@@ -57,19 +60,16 @@ std::pair<big_queue<OrderInfoXchg>, uint128> cancel_order_impl(
     auto ord = *it;
     if ((ord.client_addr == client_addr) && (!user_id || (*user_id == ord.user_id)) && (!order_id || (*order_id == ord.order_id))) {
       unsigned minus_val = is_first ? process_queue.get() : 0;
-      ITONTokenWalletPtr(ord.tip3_wallet_provide)(return_ownership).
-        returnOwnership(ord.lend_amount);
-      minus_val += return_ownership.get();
-
       unsigned plus_val = ord.account.get() + (is_first ? incoming_val.get() : 0);
       is_first = false;
-      if (plus_val > minus_val) {
-        unsigned ret_val = plus_val - minus_val;
-        OrderRet ret { uint32(ec::canceled), ord.original_amount - ord.amount, 0u128, price.num, price.denum,
-                       ord.user_id, ord.order_id, pair, major_decimals, minor_decimals, sell };
-        IPriceCallbackPtr(ord.tip3_wallet_provide)(Evers(ret_val)).
-          onOrderFinished(ret);
-      }
+      // Lend ownership must be returned anyway, so at least `return_ownership` evers are attached
+      unsigned ret_val = return_ownership.get();
+      if (plus_val > minus_val + ret_val)
+        ret_val = plus_val - minus_val;
+      OrderRet ret { uint32(ec::canceled), ord.original_amount - ord.amount, 0u128, price.num, price.denum,
+                     ord.user_id, ord.order_id, pair, major_decimals, minor_decimals, sell };
+      ITONTokenWalletPtr(ord.tip3_wallet_provide)(Evers(ret_val)).
+        onOrderFinishedReturn(ret, ord.lend_amount);
 
       all_amount -= ord.amount;
 
@@ -80,6 +80,30 @@ std::pair<big_queue<OrderInfoXchg>, uint128> cancel_order_impl(
   return { orders, all_amount };
 }
 
+/// Cancel up to \p limit orders from the queue head (for the emergency drain).
+/// Returns the rest of the queue, the rest amount and the number of canceled orders.
+__attribute__((noinline))
+std::tuple<big_queue<OrderInfoXchg>, uint128, unsigned> drain_orders_impl(
+    big_queue<OrderInfoXchg> orders, uint128 all_amount, bool sell, unsigned limit,
+    Evers return_ownership, price_t price, address pair, uint8 major_decimals, uint8 minor_decimals
+) {
+  unsigned canceled = 0;
+  while (canceled < limit && !orders.empty()) {
+    auto ord = orders.front_with_idx_opt()->second;
+    // Lend ownership must be returned anyway, so at least `return_ownership` evers are attached
+    unsigned ret_val = std::max(ord.account.get(), return_ownership.get());
+    OrderRet ret { uint32(ec::canceled), ord.original_amount - ord.amount, 0u128, price.num, price.denum,
+                   ord.user_id, ord.order_id, pair, major_decimals, minor_decimals, sell };
+    ITONTokenWalletPtr(ord.tip3_wallet_provide)(Evers(ret_val)).
+      onOrderFinishedReturn(ret, ord.lend_amount);
+
+    all_amount -= ord.amount;
+    orders.pop();
+    ++canceled;
+  }
+  return { orders, all_amount, canceled };
+}
+
 /// Is it a correct price: price.num % minmove == 0
 __always_inline
 bool is_correct_price(price_t price, uint128 minmove) {
@@ -103,6 +127,7 @@ public:
     cell        payload,
     address     answer_addr
   ) {
+    FLEX_GAS_CHECKPOINT(xchg_lend_entry);
     auto cfg = getConfig();
     price_t price { price_num_, cfg.price_denum };
     require(is_correct_price(price, cfg.minmove), ec::incorrect_price);
@@ -118,16 +143,19 @@ public:
     set_int_sender(answer_addr);
     set_int_return_value(cfg.ev_cfg.order_answer.get());
 
-    auto min_value = onTip3LendOwnershipMinValue();
+    auto min_value = calc_order_min_value(cfg.ev_cfg);
 
     auto args = parse_chain_static<FlexLendPayloadArgs>(parser(payload.ctos()));
     bool is_sell = args.sell;
     auto amount = args.amount;
+    FLEX_GAS_CHECKPOINT(xchg_lend_parsed);
 
     auto minor_amount = calc_lend_tokens_for_order(is_sell, amount, price);
 
     unsigned err = 0;
-    if (value.get() < min_value)
+    if (drained_.get())
+      err = ec::drained;
+    else if (value.get() < min_value)
       err = ec::not_enough_tons_to_process;
     else if (is_sell ? !verify_tip3_addr(cfg.major_tip3cfg, cfg, tip3_wallet, pubkey, owner) :
                        !verify_tip3_addr(cfg.minor_tip3cfg, cfg, tip3_wallet, pubkey, owner))
@@ -143,10 +171,16 @@ public:
       err = ec::have_other_side_with_non_immediate_client;
     else if (!args.post_order && (is_sell ? sells_amount_ != 0 : buys_amount_ != 0))
       err = ec::have_this_side_with_non_post_order;
+    FLEX_GAS_CHECKPOINT(xchg_lend_verified);
     if (err)
       return on_ord_fail(is_sell, cfg, err, wallet_in, balance, args.user_id, args.order_id, cfg.price_denum);
 
+    // Price is registered in XchgPair while it has enqueued orders.
+    // The first order of an empty PriceXchg pays for the registration message.
+    bool registered = !sells_.empty() || !buys_.empty();
     uint128 account = uint128(value.get()) - cfg.ev_cfg.process_queue - cfg.ev_cfg.order_answer;
+    if (!registered)
+      account -= cfg.ev_cfg.send_notify;
 
     OrderInfoXchg ord {
       args.immediate_client, args.post_order, amount, amount, account, balance, tip3_wallet,
@@ -171,21 +205,24 @@ public:
     IFlexNotifyPtr(cfg.notify_addr)(Evers(cfg.ev_cfg.send_notify.get())).
       onXchgOrderAdded(is_sell, cfg.major_tip3cfg.root_address, cfg.minor_tip3cfg.root_address,
                        price.numerator(), price.denominator(), ord.amount, notify_amount);
+    FLEX_GAS_CHECKPOINT(xchg_lend_enqueued);
 
-    auto [sells, buys, ret] =
+    auto [sells, buys, ret, stats] =
       process_queue_impl(price, cfg.pair, cfg.major_tip3cfg, cfg.minor_tip3cfg, cfg.ev_cfg,
                          sells_amount_, sells_, buys_amount_, buys_,
                          cfg.min_amount, cfg.deals_limit, uint8(c_msgs_limit),
                          cfg.notify_addr, cfg.major_reserve_wallet, cfg.minor_reserve_wallet,
                          sell_idx, buy_idx
                          );
+    FLEX_GAS_CHECKPOINT(xchg_lend_matched);
     sells_ = sells.orders_;
     buys_ = buys.orders_;
     sells_amount_ = sells.all_amount_;
     buys_amount_ = buys.all_amount_;
+    update_stats(stats);
 
-    if (sells_.empty() && buys_.empty())
-      suicide(cfg.flex);
+    sync_registration(cfg, registered);
+    FLEX_GAS_CHECKPOINT(xchg_lend_done);
     if (ret) return *ret;
     return { uint32(ok), 0u128, ord.amount, price.num, price.denum, ord.user_id, ord.order_id,
              cfg.pair, cfg.major_tip3cfg.decimals, cfg.minor_tip3cfg.decimals, is_sell };
@@ -195,20 +232,22 @@ public:
     if (sells_.empty() || buys_.empty())
       return;
 
+    FLEX_GAS_CHECKPOINT(xchg_queue_entry);
     auto cfg = getConfig();
-    auto [sells, buys, ret] =
+    auto [sells, buys, ret, stats] =
       process_queue_impl({price_num_, cfg.price_denum}, cfg.pair, cfg.major_tip3cfg, cfg.minor_tip3cfg, cfg.ev_cfg,
                          sells_amount_, sells_, buys_amount_, buys_,
                          cfg.min_amount, cfg.deals_limit, uint8(c_msgs_limit),
                          cfg.notify_addr, cfg.major_reserve_wallet, cfg.minor_reserve_wallet,
                          0, 0
                          );
+    FLEX_GAS_CHECKPOINT(xchg_queue_matched);
     sells_ = sells.orders_;
     buys_ = buys.orders_;
     sells_amount_ = sells.all_amount_;
     buys_amount_ = buys.all_amount_;
-    if (sells_.empty() && buys_.empty())
-      suicide(cfg.flex);
+    update_stats(stats);
+    sync_registration(cfg, true);
   }
 
   void cancelOrder(
@@ -246,8 +285,7 @@ public:
       onXchgOrderCanceled(sell, cfg.major_tip3cfg.root_address, cfg.minor_tip3cfg.root_address,
                           price_num_, cfg.price_denum, canceled_amount, rest_amount);
 
-    if (sells_.empty() && buys_.empty())
-      suicide(cfg.flex);
+    sync_registration(cfg, true);
   }
 
   void cancelWalletOrder(
@@ -292,8 +330,48 @@ public:
       onXchgOrderCanceled(sell, cfg.major_tip3cfg.root_address, cfg.minor_tip3cfg.root_address,
                           price_num_, cfg.price_denum, canceled_amount, rest_amount);
 
-    if (sells_.empty() && buys_.empty())
-      suicide(cfg.flex);
+    sync_registration(cfg, true);
+  }
+
+  void drain() {
+    auto cfg = getConfig();
+    require(int_sender() == cfg.pair || int_sender() == address{tvm_myaddr()}, ec::drain_not_from_pair);
+    drained_ = true;
+    price_t price { price_num_, cfg.price_denum };
+    Evers ret_owner(cfg.ev_cfg.return_ownership.get());
+    IFlexNotifyPtr notify(cfg.notify_addr);
+
+    unsigned limit = c_drain_orders_limit;
+    if (!sells_.empty()) {
+      uint128 canceled_amount = sells_amount_;
+      auto [sells, sells_amount, canceled] =
+        drain_orders_impl(sells_, sells_amount_, true, limit, ret_owner, price,
+                          cfg.pair, cfg.major_tip3cfg.decimals, cfg.minor_tip3cfg.decimals);
+      sells_ = sells;
+      sells_amount_ = sells_amount;
+      canceled_amount -= sells_amount_;
+      limit -= canceled;
+      notify(Evers(cfg.ev_cfg.send_notify.get())).
+        onXchgOrderCanceled(true, cfg.major_tip3cfg.root_address, cfg.minor_tip3cfg.root_address,
+                            price_num_, cfg.price_denum, canceled_amount, sells_amount_);
+    }
+    if (limit && !buys_.empty()) {
+      uint128 canceled_amount = buys_amount_;
+      auto [buys, buys_amount, canceled] =
+        drain_orders_impl(buys_, buys_amount_, false, limit, ret_owner, price,
+                          cfg.pair, cfg.major_tip3cfg.decimals, cfg.minor_tip3cfg.decimals);
+      buys_ = buys;
+      buys_amount_ = buys_amount;
+      canceled_amount -= buys_amount_;
+      notify(Evers(cfg.ev_cfg.send_notify.get())).
+        onXchgOrderCanceled(false, cfg.major_tip3cfg.root_address, cfg.minor_tip3cfg.root_address,
+                            price_num_, cfg.price_denum, canceled_amount, buys_amount_);
+    }
+
+    // Continuing with a call to itself until both queues are empty
+    if (!sells_.empty() || !buys_.empty())
+      IPriceXchgPtr(address{tvm_myaddr()})(Evers(cfg.ev_cfg.process_queue.get())).drain();
+    sync_registration(cfg, true);
   }
 
   // ========== getters ==========
@@ -318,6 +396,97 @@ public:
     return { price_num_, getSells(), getBuys(), getConfig() };
   }
 
+  PriceXchgStats getStats() {
+    return stats_;
+  }
+
+  PriceXchgFillEstimate estimateOrder(
+    bool    sell,
+    bool    immediate_client,
+    bool    post_order,
+    uint128 amount,
+    uint128 evers
+  ) {
+    if (!sells_.empty() && !buys_.empty())
+      return { 0u32, 0u128, 0u128, 0u32, 0u32, 0u32, 0u128, true };
+
+    auto cfg = getConfig();
+    price_t price { price_num_, cfg.price_denum };
+
+    // The same checks as in onTip3LendOwnership (except the wallet verification)
+    unsigned err = 0;
+    if (drained_.get())
+      err = ec::drained;
+    else if (evers < calc_order_min_value(cfg.ev_cfg))
+      err = ec::not_enough_tons_to_process;
+    else if (amount < cfg.min_amount)
+      err = ec::not_enough_tokens_amount;
+    else if (!immediate_client && (sell ? buys_amount_ != 0 : sells_amount_ != 0))
+      err = ec::have_other_side_with_non_immediate_client;
+    else if (!post_order && (sell ? sells_amount_ != 0 : buys_amount_ != 0))
+      err = ec::have_this_side_with_non_post_order;
+    if (err)
+      return { uint32(err), 0u128, 0u128, 0u32, 0u32, 0u32, 0u128, false };
+
+    // Pushing the hypothetical order as the newest one (it will be a taker) and running the real dealer.
+    // Out messages are discarded, because it is a getter.
+    uint128 account = evers - cfg.ev_cfg.process_queue - cfg.ev_cfg.order_answer;
+    if (sells_.empty() && buys_.empty())
+      account -= cfg.ev_cfg.send_notify;
+    auto null_addr = address::make_std(0i8, 0u256);
+    OrderInfoXchg ord {
+      immediate_client, post_order, amount, amount, account,
+      calc_lend_tokens_for_order(sell, amount, price), null_addr,
+      null_addr, uint32(tvm_now() + safe_delay_period * 2), 0u256, 0u256,
+      uint64{__builtin_tvm_ltime()}
+      };
+    unsigned sell_idx = 0;
+    unsigned buy_idx = 0;
+    if (sell) {
+      sells_.push(ord);
+      sells_amount_ += ord.amount;
+      sell_idx = sells_.back_with_idx().first;
+    } else {
+      buys_.push(ord);
+      buys_amount_ += ord.amount;
+      buy_idx = buys_.back_with_idx().first;
+    }
+
+    // Queues are one-sided here (no pending continuation), so all simulated deals are the deals of the hypothetical order
+    PriceXchgFillEstimate est { uint32(ok), 0u128, 0u128, 0u32, 0u32, 0u32, 0u128, false };
+    opt<OrderRet> ord_ret;
+    for (unsigned i = 0; i <= c_estimate_continuations_limit; ++i) {
+      auto [sells, buys, ret, stats] =
+        process_queue_impl(price, cfg.pair, cfg.major_tip3cfg, cfg.minor_tip3cfg, cfg.ev_cfg,
+                           sells_amount_, sells_, buys_amount_, buys_,
+                           cfg.min_amount, cfg.deals_limit, uint8(c_msgs_limit),
+                           cfg.notify_addr, cfg.major_reserve_wallet, cfg.minor_reserve_wallet,
+                           sell_idx, buy_idx
+                           );
+      sells_ = sells.orders_;
+      buys_ = buys.orders_;
+      sells_amount_ = sells.all_amount_;
+      buys_amount_ = buys.all_amount_;
+      if (ret)
+        ord_ret = ret;
+      est.deals += stats.deals;
+      est.filled += stats.deals_amount;
+      est.deal_msgs += stats.deal_msgs;
+      est.deals_evers += stats.deals_evers;
+      if (!stats.continuation)
+        break;
+      ++est.continuations;
+    }
+    est.filled = std::min(est.filled, amount);
+    if (ord_ret) {
+      if (ord_ret->err_code != ok)
+        est.err_code = ord_ret->err_code;
+    } else {
+      est.enqueued = amount - est.filled;
+    }
+    return est;
+  }
+
   // default processing of unknown messages
   static int _fallback([[maybe_unused]] cell msg, [[maybe_unused]] slice msg_body) {
     return 0;
@@ -325,19 +494,6 @@ public:
   // =============== Support functions ==================
   DEFAULT_SUPPORT_FUNCTIONS(IPriceXchg, void)
 private:
-  uint128 onTip3LendOwnershipMinValue() {
-    // we need funds for processing:
-    // * execute this function
-    // * execute transfer from seller's tip3 wallet to buyer tip3 wallet
-    // * execute transfer from buyer's tip3 wallet to seller tip3 wallet
-    // * execute transfer from taker's tip3 wallet to reserve tip3 wallet
-    // * execute returnOwnership of tip3 wallet to return ownership to the original owner
-    // * send answer message
-    auto cfg = getConfig();
-    return cfg.ev_cfg.process_queue + 3 * cfg.ev_cfg.transfer_tip3 + cfg.ev_cfg.send_notify +
-      cfg.ev_cfg.return_ownership + cfg.ev_cfg.order_answer;
-  }
-
   __attribute__((noinline))
   static bool verify_tip3_addr(
     Tip3Config    cfg,
@@ -365,9 +521,46 @@ private:
       );
   }
 
+  /// Accumulate telemetry of a process_queue_impl call.
+  /// Queue depth is measured once per transaction, after matching (the depth of resting orders).
+  void update_stats(dealer::process_stats stats) {
+    stats_.deals += stats.deals;
+    stats_.volume += stats.deals_amount;
+    stats_.expired += stats.expired;
+    stats_.out_of_evers += stats.out_of_evers;
+    if (stats.continuation)
+      ++stats_.continuations;
+    if (auto front = sells_.front_with_idx_opt())
+      update_max_depth(front->first, sells_.back_with_idx().first);
+    if (auto front = buys_.front_with_idx_opt())
+      update_max_depth(front->first, buys_.back_with_idx().first);
+  }
+
+  /// Update maximum queue depth with the queue index span
+  void update_max_depth(unsigned front_idx, unsigned back_idx) {
+    unsigned depth = back_idx - front_idx + 1;
+    if (depth > stats_.max_depth.get())
+      stats_.max_depth = depth;
+  }
+
+  /// Keep the registration in XchgPair actual (the registry of active prices is used by the emergency drain).
+  /// Messages are sent only on transitions: registerPrice when the first order is enqueued into empty PriceXchg
+  ///  (paid by this order, see calc_order_min_value), unregisterPrice when the last order is removed.
+  /// Self-destruct when both queues are empty.
+  void sync_registration(PriceXchgSalt cfg, bool registered) {
+    bool empty = sells_.empty() && buys_.empty();
+    IXchgPairPtr pair(cfg.pair);
+    if (!empty && !registered)
+      pair(Evers(cfg.ev_cfg.send_notify.get())).registerPrice(price_num_);
+    if (empty && registered)
+      pair(Evers(cfg.ev_cfg.send_notify.get())).unregisterPrice(price_num_);
+    if (empty)
+      suicide(cfg.flex);
+  }
+
   OrderRet on_ord_fail(bool sell, PriceXchgSalt cfg, unsigned ec, ITONTokenWalletPtr wallet_in,
                        uint128 lend_amount, uint256 user_id, uint256 order_id, uint128 price_denum) {
-    wallet_in(Evers(ev_cfg().return_ownership.get())).returnOwnership(lend_amount);
+    wallet_in(Evers(cfg.ev_cfg.return_ownership.get())).returnOwnership(lend_amount);
     if (sells_.empty() && buys_.empty()) {
       set_int_return_flag(SEND_ALL_GAS | DELETE_ME_IF_I_AM_EMPTY);
     } else {
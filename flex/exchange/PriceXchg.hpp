@@ -76,6 +76,28 @@ struct PriceXchgDetails {
   PriceXchgSalt             salt;      ///< Configuration from code salt
 };
 
+/// Estimation of a hypothetical order processing (for getter)
+struct PriceXchgFillEstimate {
+  uint32  err_code;      ///< Error code the order would finish with (zero if it would be filled or enqueued)
+  uint128 filled;        ///< Amount of major tokens to be filled
+  uint128 enqueued;      ///< Amount of major tokens to stay in the queue
+  uint32  deals;         ///< Deals to be processed
+  uint32  continuations; ///< processQueue() continuations to be needed (after the order transaction)
+  uint32  deal_msgs;     ///< Tip3 transfer messages to be sent for the deals (per fill cost in message hops)
+  uint128 deals_evers;   ///< Evers to be taken from orders (both sides) to pay for the deals
+  bool    queue_pending; ///< processQueue() continuation is pending (both sides are enqueued), nothing is estimated
+};
+
+/// Cumulative matching telemetry of PriceXchg (since deploy)
+struct PriceXchgStats {
+  uint64  deals;         ///< Deals processed
+  uint128 volume;        ///< Summarized amount of major tokens in deals
+  uint64  expired;       ///< Expired orders dropped
+  uint64  out_of_evers;  ///< Out-of-evers orders dropped
+  uint64  continuations; ///< processQueue() continuations sent to itself
+  uint32  max_depth;     ///< Maximum queue depth (index span of one side queue, including canceled holes)
+};
+
 /** \interface IPriceXchg
  *  \brief PriceXchg contract interface.
  *
@@ -120,6 +142,30 @@ __interface IPriceXchg {
   /// Get contract details
   [[getter]]
   PriceXchgDetails getDetails() = 206;
+
+  /// Simulate processing of a hypothetical order against the current queues (read-only).
+  /// Expired and out-of-evers orders are skipped as in the real processing.
+  /// While a processQueue() continuation is pending, the queues have both sides and the result
+  ///  is empty with `queue_pending` flag set: the pending deals would be mixed with the order deals.
+  [[getter]]
+  PriceXchgFillEstimate estimateOrder(
+    bool    sell,             ///< Is it a sell order
+    bool    immediate_client, ///< Order `immediate_client` flag
+    bool    post_order,       ///< Order `post_order` flag
+    uint128 amount,           ///< Amount of major tokens
+    uint128 evers             ///< Evers to be sent with the order
+  ) = 207;
+
+  /// \brief Emergency drain: cancel all orders returning lend tokens and evers to their owners.
+  /** May only be called by XchgPair (IXchgPair::drain) or by itself for continuation.
+      Cancels up to a bounded batch of orders per transaction and continues with a call to itself.
+      The contract self-destructs when both queues become empty. **/
+  [[internal, noaccept]]
+  void drain() = 208;
+
+  /// Get cumulative matching telemetry
+  [[getter]]
+  PriceXchgStats getStats() = 209;
 };
 using IPriceXchgPtr = handle<IPriceXchg>;
 
@@ -133,6 +179,8 @@ struct DPriceXchg {
 
   big_queue<OrderInfoXchg> sells_; ///< Queue of sell orders.
   big_queue<OrderInfoXchg> buys_;  ///< Queue of buy orders.
+  bool_t                   drained_; ///< Emergency drain is started, new orders are rejected.
+  PriceXchgStats           stats_; ///< Cumulative matching telemetry.
 };
 
 /// \interface EPriceXchg
@@ -7,6 +7,7 @@
 #include "XchgPair.hpp"
 #include "calc_wrapper_reserve_wallet.hpp"
 #include "PriceXchgSalt.hpp"
+#include "PriceXchg.hpp"
 #include <tvm/contract.hpp>
 #include <tvm/smart_switcher.hpp>
 #include <tvm/contract_handle.hpp>
@@ -29,8 +30,16 @@ public:
     static constexpr unsigned zero_min_amount                = 103; ///< Zero minimum amount
     static constexpr unsigned only_flex_may_deploy_me        = 104; ///< Only Flex may deploy this contract
     static constexpr unsigned not_initialized                = 105; ///< Is not correctly initialized
+    static constexpr unsigned zero_price_num                 = 106; ///< Zero price numerator
+    static constexpr unsigned unverified_price_xchg          = 107; ///< Sender is not PriceXchg of this pair
+    static constexpr unsigned zero_price_num_step            = 108; ///< Zero price numerator step
   };
 
+  /// PriceXchg contracts requested to drain in one transaction (each address calculation is a code salt + hash)
+  static constexpr unsigned prices_per_transaction = 100;
+  /// Maximum PriceXchg addresses calculated in one getPriceXchgAddresses call
+  static constexpr unsigned addresses_per_getter = 100;
+
   void onDeploy(
     uint128    min_amount,
     uint128    minmove,
@@ -151,6 +160,103 @@ public:
     return build_chain_static(preparePriceXchgSalt(cfg));
   }
 
+  XchgPairOrderPrep prepareOrder(
+    bool    sell,
+    uint128 price_num,
+    uint128 amount,
+    uint256 wallet_pubkey,
+    address client_addr
+  ) {
+    require(price_num != 0, error_code::zero_price_num);
+    int8 workchain_id = std::get<addr_std>(tvm_myaddr().val()).workchain_id;
+    auto tip3cfg = sell ? *major_tip3cfg_ : *minor_tip3cfg_;
+    auto wallet_std_addr = calc_int_wallet_init_hash(
+      tip3cfg, wallet_pubkey, client_addr,
+      uint256(TIP3_WALLET_CODE_HASH), uint16(TIP3_WALLET_CODE_DEPTH), workchain_id
+    );
+    return {
+      price_xchg_addr(getPriceXchgCode(true), price_num),
+      calc_lend_tokens_for_order(sell, amount, price_t{price_num, price_denum_}),
+      calc_order_min_value(getConfig().ev_cfg),
+      address::make_std(workchain_id, wallet_std_addr),
+      amount >= min_amount_
+    };
+  }
+
+  void registerPrice(uint128 price_num) {
+    require(int_sender() == price_xchg_addr(getPriceXchgCode(true), price_num), error_code::unverified_price_xchg);
+    // Registration sent before the drain is started may arrive after the registry walk,
+    //  such PriceXchg is drained right away instead of the registration
+    if (drain_evers_) {
+      IPriceXchgPtr(int_sender())(Evers(drain_evers_->get())).drain();
+      ++drained_prices_;
+      return;
+    }
+    prices_.set_at(price_num, bool_t(true));
+  }
+
+  void unregisterPrice(uint128 price_num) {
+    require(int_sender() == price_xchg_addr(getPriceXchgCode(true), price_num), error_code::unverified_price_xchg);
+    prices_.erase(price_num);
+  }
+
+  void drain(uint128 price_evers) {
+    auto flex = getConfig().flex;
+    // Continuation calls are sent by XchgPair itself
+    require(int_sender() == flex || int_sender() == address{tvm_myaddr()}, error_code::message_sender_is_not_my_owner);
+
+    tvm_rawreserve(tvm_balance() - int_value().get(), rawreserve_flag::up_to);
+    drain_evers_ = price_evers;
+
+    // Drained price will unregister itself later, so it is removed from the registry right now
+    auto salted_code = getPriceXchgCode(true);
+    unsigned requested = 0;
+    while (requested < prices_per_transaction && !prices_.empty()) {
+      auto price_num = (*prices_.begin()).first;
+      prices_.erase(price_num);
+      IPriceXchgPtr(price_xchg_addr(salted_code, price_num))(Evers(price_evers.get())).drain();
+      ++requested;
+    }
+    drained_prices_ += requested;
+    if (!prices_.empty())
+      IXchgPairPtr(address{tvm_myaddr()})(0_ev, SEND_ALL_GAS).drain(price_evers);
+    else
+      tvm_transfer(flex, 0, false, SEND_ALL_GAS);
+  }
+
+  XchgPairDrainDetails getDrainDetails() {
+    return { uint32(prices_.size()), drained_prices_ };
+  }
+
+  dict_array<address> getPriceXchgAddresses(uint128 price_num_from, uint128 price_num_step, uint32 count) {
+    require(price_num_from != 0, error_code::zero_price_num);
+    require(price_num_step != 0, error_code::zero_price_num_step);
+    auto salted_code = getPriceXchgCode(true);
+    unsigned limit = std::min<unsigned>(count.get(), addresses_per_getter);
+    dict_array<address> rv;
+    // Calculated in 257-bit integers, the range stops at the last price numerator fitting into uint128
+    unsigned price_num = price_num_from.get();
+    for (unsigned i = 0; i < limit && !(price_num >> 128); ++i) {
+      rv.push_back(price_xchg_addr(salted_code, uint128(price_num)));
+      price_num += price_num_step.get();
+    }
+    return rv;
+  }
+
+  /// PriceXchg address for the price (the contract may be not deployed)
+  address price_xchg_addr(cell salted_code, uint128 price_num) {
+    DPriceXchg price_data {
+      .price_num_    = price_num,
+      .sells_amount_ = 0u128,
+      .buys_amount_  = 0u128,
+      .sells_        = {},
+      .buys_         = {},
+      .stats_        = {}
+    };
+    int8 workchain_id = std::get<addr_std>(tvm_myaddr().val()).workchain_id;
+    return address::make_std(workchain_id, prepare<IPriceXchg>(price_data, salted_code).second);
+  }
+
   PriceXchgSalt preparePriceXchgSalt(XchgPairSalt cfg) {
     return {
       .flex                 = cfg.flex,
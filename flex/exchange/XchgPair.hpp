@@ -13,6 +13,7 @@
 #include <tvm/schema/message.hpp>
 #include <tvm/smart_switcher.hpp>
 #include <tvm/contract_handle.hpp>
+#include <tvm/small_dict_map.hpp>
 
 namespace tvm {
 
@@ -32,6 +33,21 @@ struct XchgPairDetails {
   bool        unlisted;             ///< If pair is unlisted
 };
 
+/// Everything a client needs to place an order (for getter)
+struct XchgPairOrderPrep {
+  address price_xchg;  ///< PriceXchg address for the price (may be not deployed yet, it is deployed with the first order)
+  uint128 lend_amount; ///< Tokens to lend for the order (including fees)
+  uint128 min_evers;   ///< Minimum evers to send with the order (PriceXchg fails with not_enough_tons_to_process below)
+  address wallet;      ///< Client's FlexWallet to lend tokens from (major for sell, minor for buy)
+  bool    amount_ok;   ///< Amount is not less than the pair min_amount
+};
+
+/// XchgPair emergency drain progress (for getter)
+struct XchgPairDrainDetails {
+  uint32 active_prices;  ///< Registered PriceXchg contracts (with enqueued orders) not requested to drain yet
+  uint32 drained_prices; ///< PriceXchg contracts requested to drain
+};
+
 /** \interface IXchgPair
  *  \brief XchgPair contract interface.
  */
@@ -77,6 +93,49 @@ __interface IXchgPair {
   /// Get PriceXchg salt (configuration) for this pair
   [[getter]]
   cell getPriceXchgSalt() = 15;
+
+  /// Prepare order parameters: PriceXchg address, lend tokens, minimum evers and client wallet
+  [[getter]]
+  XchgPairOrderPrep prepareOrder(
+    bool    sell,          ///< Is it a sell order
+    uint128 price_num,     ///< Price numerator (denominator is the pair price_denum)
+    uint128 amount,        ///< Amount of major tokens
+    uint256 wallet_pubkey, ///< Client's FlexWallet pubkey
+    address client_addr    ///< Client's FlexWallet owner (FlexClient)
+  ) = 16;
+
+  /// Register active PriceXchg. Sent by PriceXchg when it gets its first enqueued order.
+  /// After the emergency drain is started, the PriceXchg is requested to drain instead of registration.
+  [[internal]]
+  void registerPrice(uint128 price_num) = 17;
+
+  /// Unregister PriceXchg. Sent by PriceXchg when its queues become empty (before self-destruct).
+  [[internal]]
+  void unregisterPrice(uint128 price_num) = 18;
+
+  /// Emergency drain: request all registered PriceXchg contracts to cancel their orders (IPriceXchg::drain).
+  /// May only be called by Flex or by itself for continuation (in batches).
+  /// The remaining evers are returned to Flex.
+  [[internal]]
+  void drain(
+    uint128 price_evers ///< Evers to send in each IPriceXchg::drain call
+  ) = 19;
+
+  /// Get emergency drain progress
+  [[getter]]
+  XchgPairDrainDetails getDrainDetails() = 20;
+
+  /// Get PriceXchg addresses for a range of prices (contracts may be not deployed).
+  /// Salted PriceXchg code is prepared once for the whole batch.
+  /// Returns addresses for price numerators `price_num_from + i * price_num_step`, i in [0, count),
+  ///  no more than `addresses_per_getter` in one call. Step must be non-zero,
+  ///  the range is cut at the last price numerator fitting into uint128.
+  [[getter]]
+  dict_array<address> getPriceXchgAddresses(
+    uint128 price_num_from, ///< First price numerator (denominator is the pair price_denum)
+    uint128 price_num_step, ///< Price numerator step
+    uint32  count           ///< Number of prices
+  ) = 21;
 };
 using IXchgPairPtr = handle<IXchgPair>;
 
@@ -95,6 +154,9 @@ struct DXchgPair {
   opt<Tip3Config> minor_tip3cfg_; ///< Configuration of the minor tip3 token.
   opt<address>    next_;          ///< Next XchgPair address
   bool_t          unlisted_;      ///< If pair is unlisted
+  small_dict_map<uint128, bool_t> prices_; ///< Registered PriceXchg contracts by price numerator (for the emergency drain)
+  uint32          drained_prices_; ///< PriceXchg contracts requested to drain
+  opt<uint128>    drain_evers_;    ///< Evers for IPriceXchg::drain calls, set when the emergency drain is started
 };
 
 /// \interface EXchgPair
@@ -43,11 +43,23 @@ public:
       major_reserve_wallet_(major_reserve_wallet), minor_reserve_wallet_(minor_reserve_wallet) {
   }
 
+  /// Processing statistics of process() call
+  struct process_stats {
+    unsigned deals;        ///< Deals processed
+    uint128  deals_amount; ///< Summarized amount of major tokens in deals
+    bool     continuation; ///< processQueue() to self was sent (queues are still crossing)
+    unsigned deal_msgs;    ///< Tip3 transfer messages sent for the deals
+    uint128  deals_evers;  ///< Evers taken from orders to pay for the deals
+    unsigned expired;      ///< Expired orders dropped
+    unsigned out_of_evers; ///< Out-of-evers orders dropped
+  };
+
   /// Result of process() call
   struct process_result {
-    orders_queue sells; ///< Sell orders queue
-    orders_queue buys;  ///< Buy orders queue
-    opt<OrderRet> ret;  ///< Return value for the called function
+    orders_queue  sells; ///< Sell orders queue
+    orders_queue  buys;  ///< Buy orders queue
+    opt<OrderRet> ret;   ///< Return value for the called function
+    process_stats stats; ///< Processing statistics
   };
 
   /// Process order queues and make deals
@@ -55,6 +67,9 @@ public:
     process_queue_state state(price_, pair_, major_tip3cfg_, minor_tip3cfg_, ev_cfg_, min_amount_, deals_limit_, msgs_limit_,
                               notify_addr_, sell_idx, buy_idx);
 
+    bool continuation = false;
+    unsigned deal_msgs = 0;
+    uint128 deals_evers;
     {
       orders_queue_cached sells(sells_);
       xchg_iterator sells_iter(state, sells, deal_costs_, true);
@@ -71,12 +86,15 @@ public:
           sells_iter.on_deal(res.deal_amount, res.seller_costs, res.seller_lend_spent);
           buys_iter.on_deal(res.deal_amount, res.buyer_costs, res.buyer_lend_spent);
           state.on_deal(res.seller_taker, res.deal_amount);
+          deal_msgs += res.msgs;
+          deals_evers += res.seller_costs + res.buyer_costs;
         }
       }
       // In case of overlimit, we need to send IPriceXchg::processQueue() to self
       if (sells_iter.first_active() && buys_iter.first_active()) {
         IPriceXchgPtr(address{tvm_myaddr()})(Evers(ev_cfg_.process_queue.get())).
           processQueue();
+        continuation = true;
       }
     }
 
@@ -95,7 +113,9 @@ public:
     return {
       sells_,
       buys_,
-      state.ret_
+      state.ret_,
+      { static_cast<unsigned>(state.deals_processed_.get()), state.sum_deals_amount_, continuation, deal_msgs, deals_evers,
+        static_cast<unsigned>(state.expired_.get()), static_cast<unsigned>(state.out_of_evers_.get()) }
       };
   }
 
@@ -109,6 +129,7 @@ public:
     uint128 buyer_costs;       ///< Buyer evers costs to be taken
     uint128 seller_lend_spent; ///< Seller lend tokens spent (major tokens for seller)
     uint128 buyer_lend_spent;  ///< Buyer lend tokens spent (minor tokens for buyer)
+    unsigned msgs;             ///< Tip3 transfer messages sent
   };
 
   /// Make tip3/tip exchange deal
@@ -143,6 +164,7 @@ public:
 
     uint128 seller_lend_spent;
     uint128 buyer_lend_spent;
+    unsigned msgs = 2;
 
     // (seller_taker & buyer_maker) || (seller_maker & buyer_taker)
     // We have values:
@@ -222,6 +244,7 @@ public:
                             build_chain_static(buyer_payload));
       // Transfer of major tokens from seller to major reserve wallet
       if (reserve_val > 0) {
+        ++msgs;
         ITONTokenWalletPtr(sell.tip3_wallet_provide)(Evers(ev_cfg_.transfer_tip3.get())).
           transfer({}, major_reserve_wallet_, reserve_val, 0u128, 0u128,
                    build_chain_static(seller_payload));
@@ -276,6 +299,7 @@ public:
                             build_chain_static(seller_payload));
       // Transfer of minor tokens from buyer to minor reserve wallet
       if (reserve_val > 0) {
+        ++msgs;
         ITONTokenWalletPtr(buy.tip3_wallet_provide)(Evers(ev_cfg_.transfer_tip3.get())).
           transfer({}, minor_reserve_wallet_, reserve_val, 0u128, 0u128,
                    build_chain_static(buyer_payload));
@@ -284,7 +308,7 @@ public:
     return {
       .seller_taker = seller_taker, false, false, deal_amount,
       seller_costs, buyer_costs,
-      seller_lend_spent, buyer_lend_spent
+      seller_lend_spent, buyer_lend_spent, msgs
     };
   }
 
@@ -30,6 +30,12 @@ struct ec : tvm::error_code {
   /** New sell order comes to a PriceXchg with enqueued sell orders.
       Or new buy order comes to a PriceXchg with enqueued buy orders. **/
   static constexpr unsigned have_this_side_with_non_post_order = 111;
+  /// \brief When emergency drain is requested not by XchgPair.
+  /** Drain may be requested only by XchgPair (IXchgPair::drain) or by PriceXchg itself for continuation. **/
+  static constexpr unsigned drain_not_from_pair = 112;
+  /// \brief When an order comes to a PriceXchg being drained.
+  /** Emergency drain is started for this PriceXchg, new orders are rejected until it self-destructs. **/
+  static constexpr unsigned drained = 113;
 };
 
 }} // namespace tvm::xchg
@@ -18,8 +18,8 @@ class process_queue_state {
 public:
   static constexpr unsigned msgs_per_deal = 4;               ///< Messages per deal completed
   static constexpr unsigned msgs_per_expired = 1;            ///< Messages per order expired
-  static constexpr unsigned msgs_per_out_of_evers = 2;       ///< Messages per order out-of-evers
-  static constexpr unsigned msgs_per_no_post_order_done = 2; ///< Messages per non-post-order partially done
+  static constexpr unsigned msgs_per_out_of_evers = 1;       ///< Messages per order out-of-evers
+  static constexpr unsigned msgs_per_no_post_order_done = 1; ///< Messages per non-post-order partially done
 
   process_queue_state(
     price_t        price,          ///< Price (rational value)
@@ -60,8 +60,8 @@ public:
   }
 
   /// When order has not enough evers to process deals,
-  ///  sending IPriceCallback::onOrderFinished() notification and
-  ///  calling ITONTokenWallet::returnOwnership() to unlock tip3 tokens in the client wallet.
+  ///  sending ITONTokenWallet::onOrderFinishedReturn() to unlock tip3 tokens in the client wallet
+  ///  and return the remaining balance in one message.
   void on_out_of_evers(OrderInfoXchgWithIdx ord_idx, bool sell) {
     auto ord = ord_idx.second;
     ++out_of_evers_;
@@ -78,11 +78,8 @@ public:
                    ord.user_id, ord.order_id, pair_, major_tip3cfg_.decimals, minor_tip3cfg_.decimals, sell };
     check_ret(sell, ord_idx.first, ret);
     if (ord.account > ev_cfg_.return_ownership) {
-      ord.account -= ev_cfg_.return_ownership;
-      ITONTokenWalletPtr(ord.tip3_wallet_provide)(Evers(ev_cfg_.return_ownership.get())).
-        returnOwnership(ord.lend_amount);
-      IPriceCallbackPtr(ord.tip3_wallet_provide)(Evers(ord.account.get())).
-        onOrderFinished(ret);
+      ITONTokenWalletPtr(ord.tip3_wallet_provide)(Evers(ord.account.get())).
+        onOrderFinishedReturn(ret, ord.lend_amount);
     }
   }
 
@@ -113,11 +110,8 @@ public:
                    ord.user_id, ord.order_id, pair_, major_tip3cfg_.decimals, minor_tip3cfg_.decimals, sell };
     check_ret(sell, ord_idx.first, ret);
     if (ord.account > ev_cfg_.return_ownership) {
-      ord.account -= ev_cfg_.return_ownership;
-      ITONTokenWalletPtr(ord.tip3_wallet_provide)(Evers(ev_cfg_.return_ownership.get())).
-        returnOwnership(ord.lend_amount);
-      IPriceCallbackPtr(ord.tip3_wallet_provide)(Evers(ord.account.get())).
-        onOrderFinished(ret);
+      ITONTokenWalletPtr(ord.tip3_wallet_provide)(Evers(ord.account.get())).
+        onOrderFinishedReturn(ret, ord.lend_amount);
     }
   }
 
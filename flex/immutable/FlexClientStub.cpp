@@ -15,6 +15,7 @@
 using namespace tvm;
 
 /// FlexClientStub contract. Implements IFlexClientStub.
+template<class ReplayProtection = flex_client_replay_protection_t>
 class FlexClientStub final : public smart_interface<IFlexClientStub>, public DFlexClientStub {
   using data = DFlexClientStub;
   static constexpr bool _checked_deploy = true; /// Deploy is only allowed with [[deploy]] function call
@@ -48,7 +49,7 @@ public:
     auth_index_code_    = auth_index_code;
     user_id_index_code_ = user_id_index_code;
 
-    cell state = prepare_persistent_data<IFlexClientStub, flex_client_replay_protection_t, data>(header_, static_cast<data&>(*this));
+    cell state = prepare_persistent_data<IFlexClientStub, ReplayProtection, data>(header_, static_cast<data&>(*this));
     tvm_setcode(flex_client_code);
     tvm_setcurrentcode(parser(flex_client_code).skipref().ldref());
     onCodeUpgrade(state);
@@ -64,7 +65,7 @@ public:
   }
 
   // =============== Support functions ==================
-  DEFAULT_SUPPORT_FUNCTIONS(IFlexClientStub, flex_client_replay_protection_t)
+  DEFAULT_SUPPORT_FUNCTIONS(IFlexClientStub, ReplayProtection)
 
   // default processing of unknown messages
   static int _fallback([[maybe_unused]] cell msg, [[maybe_unused]] slice msg_body) {
@@ -76,7 +77,12 @@ public:
   }
 };
 
-DEFINE_JSON_ABI(IFlexClientStub, DFlexClientStub, EFlexClientStub, flex_client_replay_protection_t);
-
 // ----------------------------- Main entry functions ---------------------- //
-DEFAULT_MAIN_ENTRY_FUNCTIONS(FlexClientStub, IFlexClientStub, DFlexClientStub, FLEX_CLIENT_TIMESTAMP_DELAY)
+#ifdef FLEX_CLIENT_BURST
+using FlexClientStubBurst = FlexClientStub<flex_client_burst_replay_protection_t>;
+DEFINE_JSON_ABI(IFlexClientStub, DFlexClientStub, EFlexClientStub, flex_client_burst_replay_protection_t);
+MAIN_ENTRY_FUNCTIONS_REPLAY(FlexClientStubBurst, IFlexClientStub, DFlexClientStub, flex_client_burst_replay_protection_t)
+#else
+DEFINE_JSON_ABI(IFlexClientStub, DFlexClientStub, EFlexClientStub, flex_client_replay_protection_t);
+DEFAULT_MAIN_ENTRY_FUNCTIONS(FlexClientStub<>, IFlexClientStub, DFlexClientStub, FLEX_CLIENT_TIMESTAMP_DELAY)
+#endif
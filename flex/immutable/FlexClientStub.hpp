@@ -11,6 +11,7 @@
 #include <tvm/contract_handle.hpp>
 #include <tvm/replay_attack_protection/timestamp.hpp>
 
+#include "replay_msg_hash_set.hpp"
 #include "FlexVersion.hpp"
 #include "bind_info.hpp"
 
@@ -19,6 +20,15 @@ namespace tvm {
 static constexpr unsigned FLEX_CLIENT_TIMESTAMP_DELAY = 1800;
 using flex_client_replay_protection_t = replay_attack_protection::timestamp<FLEX_CLIENT_TIMESTAMP_DELAY>;
 
+// FLEX_CLIENT_BURST - build FlexClientStubBurst, FlexClientBurst and UserDataConfigBurst
+//  with msg_hash_set replay protection, so a trading bot may send bursts of external messages
+//  in any arrival order. The replay state travels from the stub into FlexClient during onDeploy,
+//  and UserDataConfig calculates the stub addresses, so these three contracts are deployed together.
+static constexpr unsigned FLEX_CLIENT_BURST_WINDOW   = 120;
+static constexpr unsigned FLEX_CLIENT_BURST_MAX_MSGS = 256;
+using flex_client_burst_replay_protection_t =
+  replay_attack_protection::msg_hash_set<FLEX_CLIENT_BURST_WINDOW, FLEX_CLIENT_BURST_MAX_MSGS>;
+
 struct FlexClientStubSalt {
   address super_root;
 };
@@ -58,16 +68,23 @@ struct DFlexClientStub {
 __interface EFlexClientStub {
 };
 
+/// Prepare StateInit struct and std address to deploy FlexClientStub contract with \p ReplayProtection
+template<class ReplayProtection>
+__always_inline
+std::pair<StateInit, uint256> prepare_flex_client_stub(DFlexClientStub data, cell code) {
+  auto init_hdr = persistent_data_header<IFlexClientStub, ReplayProtection>::init();
+  cell data_cl = prepare_persistent_data<IFlexClientStub, ReplayProtection>(init_hdr, data);
+  StateInit init { {}, {}, code, data_cl, {} };
+  cell init_cl = build(init).make_cell();
+  return { init, uint256(tvm_hash(init_cl)) };
+}
+
 /// Prepare StateInit struct and std address to deploy FlexClientStub contract
 template<>
 struct preparer<IFlexClientStub, DFlexClientStub> {
   __always_inline
   static std::pair<StateInit, uint256> execute(DFlexClientStub data, cell code) {
-    auto init_hdr = persistent_data_header<IFlexClientStub, flex_client_replay_protection_t>::init();
-    cell data_cl = prepare_persistent_data<IFlexClientStub, flex_client_replay_protection_t>(init_hdr, data);
-    StateInit init { {}, {}, code, data_cl, {} };
-    cell init_cl = build(init).make_cell();
-    return { init, uint256(tvm_hash(init_cl)) };
+    return prepare_flex_client_stub<flex_client_replay_protection_t>(data, code);
   }
 };
 
@@ -42,6 +42,11 @@ public:
     static constexpr unsigned double_initialization          = 104; ///< Double initialization
     static constexpr unsigned uninitialized                  = 105; ///< Uninitialized
     static constexpr unsigned not_allowed_during_update      = 106; ///< Not allowed during update
+    static constexpr unsigned abandon_ship_not_set           = 107; ///< `abandon_ship` flag is not set
+    static constexpr unsigned bad_evers_config               = 108; ///< EversConfig is out of bounds (see is_valid_evers_config)
+    static constexpr unsigned too_many_messages              = 109; ///< Too many messages in proxyBatch
+    static constexpr unsigned bad_batch_message              = 110; ///< proxyBatch message is not an internal message
+    static constexpr unsigned not_enough_evers               = 111; ///< Not enough evers for proxyBatch messages and fees
   };
 
   void onDeploy(
@@ -75,12 +80,18 @@ public:
     IGlobalConfigPtr ptr(address::make_std(workchain_id_, hash));
     ptr.deploy(init, Evers(cfg_deploy_evers.get())).onDeploy(cfg_keep_evers, wrappers_cfg, flex, user_cfg, description);
     deploying_cfg_ = ptr.get();
+    opt<FlexUserCodeHashes> user_code_hashes;
+    if (last_user_cfg_ && *last_user_cfg_ == user_cfg)
+      user_code_hashes = last_user_code_hashes_;
+    deploying_components_ = FlexComponents{ wrappers_cfg, flex, user_cfg, user_code_hashes };
   }
 
   void updateConfirmed(FlexVersion version) {
     require(deploying_cfg_ && *deploying_cfg_ == int_sender(), error_code::unexpected_confirmation);
     beta_version_ = version;
+    beta_components_ = deploying_components_;
     deploying_cfg_.reset();
+    deploying_components_.reset();
   }
 
   void release() {
@@ -88,7 +99,9 @@ public:
     check_owner({ .allowed_for_update_team = false });
 
     version_ = beta_version_;
+    components_ = beta_components_;
     beta_version_.reset();
+    beta_components_.reset();
     update_started_ = false;
   }
 
@@ -104,6 +117,28 @@ public:
     tvm_sendmsg(msg, SEND_ALL_GAS);
   }
 
+  void proxyBatch(
+    dict_array<cell> msgs,
+    bool             cant_work_during_update,
+    bool             starting_update
+  ) {
+    require(!cant_work_during_update || !update_started_.get() || !version_, error_code::not_allowed_during_update);
+    if (starting_update)
+      update_started_ = true;
+    check_owner({ .allowed_for_update_team = false });
+    require(msgs.size() <= super_root_max_batch_msgs, error_code::too_many_messages);
+    uint128 total(msgs.size() * super_root_batch_msg_fee);
+    for (auto msg : msgs) {
+      auto msg_info = parse<int_msg_info>(parser(msg), error_code::bad_batch_message);
+      total += uint128(msg_info.value.grams.get());
+    }
+    require(total.get() <= int_value().get(), error_code::not_enough_evers);
+
+    // SuperRoot balance is reserved by check_owner, the change returns to the sender with SEND_ALL_GAS
+    for (auto msg : msgs)
+      tvm_sendmsg(msg, SENDER_WANTS_TO_PAY_FEES_SEPARATELY);
+  }
+
   void addWrapperType(
     uint128 call_evers,
     uint128 wrappers_cfg_keep_evers,
@@ -159,7 +194,7 @@ public:
 
     auto [init, hash] = prepare<IWrappersConfig>(DWrappersConfig{.token_version_ = token_version}, salted_code);
     IWrappersConfigPtr ptr(address::make_std(workchain_id_, hash));
-    ptr.deploy(init, Evers(deploy_evers.get())).onDeploy(wrappers_cfg_keep_evers, {}, {}, {}, {}, {}, 0u32);
+    ptr.deploy(init, Evers(deploy_evers.get())).onDeploy(wrappers_cfg_keep_evers, {}, {}, {}, {}, {}, 0u32, {});
     update_started_ = true;
 
     return ptr.get();
@@ -178,6 +213,7 @@ public:
     uint8          deals_limit
   ) {
     check_owner({ .allowed_for_update_team = true });
+    require(is_valid_evers_config(ev_cfg), error_code::bad_evers_config);
     FlexSalt salt {
       .super_root      = tvm_myaddr(),
       .ev_cfg          = ev_cfg,
@@ -212,6 +248,10 @@ public:
     ptr.deploy(init, Evers(deploy_evers.get())).
       onDeploy(binding, flex_client_stub_.get(), flex_client_code, auth_index_code, user_id_index_code);
     update_started_ = true;
+    last_user_cfg_ = ptr.get();
+    last_user_code_hashes_ = FlexUserCodeHashes{
+      uint256(tvm_hash(flex_client_code)), uint256(tvm_hash(auth_index_code)), uint256(tvm_hash(user_id_index_code))
+    };
 
     return ptr.get();
   }
@@ -263,6 +303,16 @@ public:
     if (update_started) update_started_ = *update_started;
   }
 
+  void drainFlex(
+    address flex,
+    uint128 pair_evers,
+    uint128 price_evers
+  ) {
+    check_owner({ .allowed_for_update_team = false });
+    require(abandon_ship_.get(), error_code::abandon_ship_not_set);
+    IFlexPtr(flex)(0_ev, SEND_ALL_GAS).drain(pair_evers, price_evers, 0u32);
+  }
+
   void setOwner(
     address owner
   ) {
@@ -309,6 +359,20 @@ public:
     return getGlobalConfig(*version_);
   }
 
+  SuperRootBootstrap getBootstrap() {
+    require(global_config_code_ && flex_client_stub_, error_code::uninitialized);
+    address_opt cur_cfg, beta_cfg;
+    if (version_)
+      cur_cfg = getGlobalConfig(*version_);
+    if (beta_version_)
+      beta_cfg = getGlobalConfig(*beta_version_);
+    return {
+      stop_trade_.get(), abandon_ship_.get(), update_started_.get(), next_super_root_, revision_,
+      uint256(tvm_hash(flex_client_stub_.get())),
+      version_, cur_cfg, components_, beta_version_, beta_cfg, beta_components_
+    };
+  }
+
   // default processing of unknown messages
   static int _fallback([[maybe_unused]] cell msg, [[maybe_unused]] slice msg_body) {
     return 0;
@@ -19,6 +19,11 @@
 
 namespace tvm {
 
+/// Max messages in one proxyBatch (one out action each plus the change, out actions limit is 255)
+static constexpr unsigned super_root_max_batch_msgs = 250;
+/// Forward fee allowance for each proxyBatch message (fees are paid separately from the message value)
+static constexpr unsigned super_root_batch_msg_fee = 10000000;
+
 /// SuperRoot details for getter
 struct SuperRootDetails {
   uint256          pubkey;             ///< Deployer public key
@@ -40,6 +45,37 @@ struct SuperRootDetails {
   uint32           revision;           ///< SuperRoot revision
 };
 
+/// Unsalted code hashes of user contracts (to check client code cache)
+struct FlexUserCodeHashes {
+  uint256 flex_client_code_hash;   ///< FlexClient code hash (unsalted)
+  uint256 auth_index_code_hash;    ///< AuthIndex code hash (unsalted)
+  uint256 user_id_index_code_hash; ///< UserIdIndex code hash (unsalted)
+};
+
+/// Flex system components of a version (the same as in GlobalConfig)
+struct FlexComponents {
+  address                 wrappers_cfg;     ///< WrappersConfig address
+  address                 flex;             ///< Flex root address
+  address                 user_cfg;         ///< UserDataConfig address
+  opt<FlexUserCodeHashes> user_code_hashes; ///< User contracts code hashes (if UserDataConfig was deployed by this SuperRoot)
+};
+
+/// Everything a client needs to start in one getter. Code cells may be requested by hash from UserDataConfig::getCodeByHash.
+struct SuperRootBootstrap {
+  bool                stop_trade;            ///< Recommendation to stop trading
+  bool                abandon_ship;          ///< Recommendation to cancel all orders and withdraw funds
+  bool                update_started;        ///< Update procedures started
+  address_opt         next_super_root;       ///< Will be set up if new super root is deployed and should be used instead
+  uint32              revision;              ///< SuperRoot revision
+  uint256             flex_client_stub_hash; ///< FlexClientStub code hash (salted)
+  opt<FlexVersion>    version;               ///< Current Flex version
+  address_opt         cur_cfg;               ///< Current GlobalConfig
+  opt<FlexComponents> components;            ///< Current version components
+  opt<FlexVersion>    beta_version;          ///< Beta Flex version
+  address_opt         beta_cfg;              ///< Beta GlobalConfig
+  opt<FlexComponents> beta_components;       ///< Beta version components
+};
+
 /** \interface ISuperRoot
  *  \brief SuperRoot contract interface.
  *  SuperRoot is an immutable flex super root contract, persistent through updates.
@@ -109,7 +145,7 @@ __interface ISuperRoot {
     cell           flex_code,        ///< Code of Flex contract (unsalted)
     cell           xchg_pair_code,   ///< Code of XchgPair contract (unsalted)
     cell           xchg_price_code,  ///< Code of PriceXchg contract (unsalted)
-    EversConfig    ev_cfg,           ///< Processing costs configuration of Flex in native funds (evers)
+    EversConfig    ev_cfg,           ///< Processing costs configuration of Flex in native funds (evers), checked by is_valid_evers_config
     uint8          deals_limit       ///< Limit for processed deals in one request
   ) = 16;
 
@@ -188,6 +224,31 @@ __interface ISuperRoot {
   /// Get current GlobalConfig address
   [[getter]]
   address getCurrentGlobalConfig() = 27;
+
+  /// Perform several proxy calls in one transaction with one update state check.
+  /// Each message must carry its own evers value. All messages are sent or none (action phase fails atomically).
+  /// Incoming value must cover message values plus super_root_batch_msg_fee per message, the change is returned.
+  /// Up to super_root_max_batch_msgs messages.
+  [[internal]]
+  void proxyBatch(
+    dict_array<cell> msgs,                   ///< Messages to send from SuperRoot
+    bool             cant_work_during_update, ///< Operations must fail if update procedure is already started
+    bool             starting_update          ///< These operations starting update
+  ) = 28;
+
+  /// Get current and beta system addresses, versions and code hashes in one call
+  [[getter]]
+  SuperRootBootstrap getBootstrap() = 29;
+
+  /// Emergency drain of the exchange: cancel all orders returning lend tokens and evers to the users.
+  /// Fans out Flex -> XchgPair -> PriceXchg in bounded batches (see IFlex::drain).
+  /// Allowed only when `abandon_ship` flag is set. Not allowed for the update team.
+  [[internal]]
+  void drainFlex(
+    address flex,        ///< Flex address
+    uint128 pair_evers,  ///< Evers to send to each XchgPair
+    uint128 price_evers  ///< Evers to send to each active PriceXchg
+  ) = 30;
 };
 using ISuperRootPtr = handle<ISuperRoot>;
 
@@ -208,6 +269,11 @@ struct DSuperRoot {
   address_opt      prev_super_root_;       ///< Will point to the previous super root
   address_opt      next_super_root_;       ///< Will be set up if new super root is deployed and should be used instead
   uint32           revision_;              ///< SuperRoot revision
+  opt<FlexComponents> deploying_components_; ///< Components of the deploying GlobalConfig
+  opt<FlexComponents> beta_components_;      ///< Components of the beta version
+  opt<FlexComponents> components_;           ///< Components of the current version
+  address_opt         last_user_cfg_;        ///< Last UserDataConfig deployed by this SuperRoot
+  opt<FlexUserCodeHashes> last_user_code_hashes_; ///< User contracts code hashes of the last deployed UserDataConfig
 };
 
 /// \interface ESuperRoot
@@ -121,28 +121,16 @@ public:
       auto expected_std_addr = prepare<IWIC>(DWIC{.symbol_ = *prev_symbol}, tvm_mycode()).second;
       require(int_sender() == address::make_std(workchain_id_, expected_std_addr), error_code::wrong_prev_wic_in_chain);
     } else { // Starting call from WrappersConfig clone
-      auto expected_std_addr = expected<IWrappersConfig>(
-        DWrappersConfig{.token_version_=token_version}, cfg.wrappers_cfg_code_hash, cfg.wrappers_cfg_code_depth
-      );
-      auto addr = address::make_std(workchain_id_, expected_std_addr);
-      require(int_sender() == addr && addr == new_wrappers_cfg, error_code::wrong_cloned_wrappers_cfg);
+      check_new_wrappers_cfg(cfg, token_version, new_wrappers_cfg);
     }
 
     if (!unlisted_.get()) {
-      cell newcode = resalt(cfg, new_wrappers_cfg);
-      address deployer = wrapper_deployers.get_at(type_->get());
-      auto old_wrappers_cfg = cfg.wrappers_cfg;
-      auto [init, hash] = prepare<IWIC>(DWIC{.symbol_ = symbol_}, newcode);
-      IWICPtr wic(address::make_std(workchain_id_, hash));
-      // If deployer is not changed,
-      bool keep_wrapper = (deployer == *deployer_);
-      wic.deploy(init, Evers(evers.deploy.get())).
-        onDeploy(evers.wic_keep, old_wrappers_cfg, wrapper_, keep_wrapper, deployer, *type_, *init_args_);
+      auto wic = deploy_clone(cfg, evers, new_wrappers_cfg, wrapper_deployers);
       if (last_clone)
-        IWICPtr(*last_clone)(Evers(evers.setnext.get())).setNext(old_wrappers_cfg, symbol_, wic.get());
+        IWICPtr(*last_clone)(Evers(evers.setnext.get())).setNext(cfg.wrappers_cfg, symbol_, wic);
       if (!first_clone)
-        first_clone = wic.get();
-      last_clone = wic.get();
+        first_clone = wic;
+      last_clone = wic;
       ++wic_count;
     }
 
@@ -155,6 +143,27 @@ public:
     }
   }
 
+  void cloneUpgradeIdx(
+    uint32              idx,
+    WICCloneEvers       evers,
+    uint32              token_version,
+    address             new_wrappers_cfg,
+    dict_array<address> wrapper_deployers
+  ) {
+    require(type_ < wrapper_deployers.size(), error_code::wrong_wrapper_type);
+    require(deployer_ && type_ && init_args_, error_code::uninitialized);
+    auto cfg = getConfig();
+    check_new_wrappers_cfg(cfg, token_version, new_wrappers_cfg);
+
+    opt<address> clone;
+    if (!unlisted_.get())
+      clone = deploy_clone(cfg, evers, new_wrappers_cfg, wrapper_deployers);
+
+    // New WrappersConfig will link the clones in the old index order
+    tvm_rawreserve(evers.wic_keep.get(), rawreserve_flag::up_to);
+    IWrappersConfigPtr(new_wrappers_cfg)(0_ev, SEND_ALL_GAS).onWICCloned(idx, clone);
+  }
+
   void unlist() {
     auto wrappers_cfg = getConfig().wrappers_cfg;
     require(wrappers_cfg == int_sender(), error_code::message_sender_is_not_my_owner);
@@ -162,6 +171,28 @@ public:
     tvm_transfer(wrappers_cfg, 0, false, SEND_REST_GAS_FROM_INCOMING);
   }
 
+  /// Check that sender is the new WrappersConfig clone
+  void check_new_wrappers_cfg(WICSalt cfg, uint32 token_version, address new_wrappers_cfg) {
+    auto expected_std_addr = expected<IWrappersConfig>(
+      DWrappersConfig{.token_version_=token_version}, cfg.wrappers_cfg_code_hash, cfg.wrappers_cfg_code_depth
+    );
+    auto addr = address::make_std(workchain_id_, expected_std_addr);
+    require(int_sender() == addr && addr == new_wrappers_cfg, error_code::wrong_cloned_wrappers_cfg);
+  }
+
+  /// Deploy WIC clone for the new WrappersConfig, returns the clone address
+  address deploy_clone(WICSalt cfg, WICCloneEvers evers, address new_wrappers_cfg, dict_array<address> wrapper_deployers) {
+    cell newcode = resalt(cfg, new_wrappers_cfg);
+    address deployer = wrapper_deployers.get_at(type_->get());
+    auto [init, hash] = prepare<IWIC>(DWIC{.symbol_ = symbol_}, newcode);
+    IWICPtr wic(address::make_std(workchain_id_, hash));
+    // If deployer is not changed,
+    bool keep_wrapper = (deployer == *deployer_);
+    wic.deploy(init, Evers(evers.deploy.get())).
+      onDeploy(evers.wic_keep, cfg.wrappers_cfg, wrapper_, keep_wrapper, deployer, *type_, *init_args_);
+    return wic.get();
+  }
+
   /// Re-salt code with new configuration WICSalt
   cell resalt(WICSalt cfg, address wrappers_cfg) {
     auto code = tvm_mycode();
@@ -72,6 +72,18 @@ __interface IWIC {
     dict_array<address> wrapper_deployers ///< Wrapper deployers for different types
   ) = 12;
 
+  /// Clone this WIC to the new Flex version without chaining (fan-out upgrade).
+  /// Called by the new WrappersConfig, which is notified back with IWrappersConfig::onWICCloned.
+  /// \note `idx` goes first to be present in the bounced message.
+  [[internal]]
+  void cloneUpgradeIdx(
+    uint32              idx,              ///< Index of this WIC in the old WrappersConfig
+    WICCloneEvers       evers,            ///< Evers configuration
+    uint32              token_version,    ///< Tokens update group version
+    address             new_wrappers_cfg, ///< New WrappersConfig address
+    dict_array<address> wrapper_deployers ///< Wrapper deployers for different types
+  ) = 15;
+
   /// Mark this WIC/Wrapper as unlisted. Unlisted WIC will not be cloned during cloneUpgrade.
   [[internal]]
   void unlist() = 13;
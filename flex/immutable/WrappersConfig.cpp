@@ -34,6 +34,8 @@ public:
     static constexpr unsigned wrong_wrapper_type_num                  = 107; ///< Wrong wrapper type number
     static constexpr unsigned wrong_initialization                    = 108; ///< Wrong initialization
     static constexpr unsigned missed_evers_cfg                        = 109; ///< Missed evers configuration
+    static constexpr unsigned wrong_bounced_header                    = 110; ///< Wrong header of bounced message
+    static constexpr unsigned wrong_bounced_args                      = 111; ///< Wrong arguments in bounced message
   };
 
   void onDeploy(
@@ -43,7 +45,8 @@ public:
     dict_array<address> wrapper_deployers,
     address_opt         first_wic,
     address_opt         last_wic,
-    uint32              wic_count
+    uint32              wic_count,
+    small_dict_map<uint32, address> wics
   ) {
     require(!deployed_.get(), error_code::wrong_initialization);
     workchain_id_ = std::get<addr_std>(tvm_myaddr().val()).workchain_id;
@@ -64,6 +67,14 @@ public:
         // Last WIC will call onWICsCloned callback
         // TODO: add expecting method gas usage calculation with gastogram
         require((evers.deploy + evers.setnext + evers.wic_keep) * wic_count + keep_evers < int_value().get(), error_code::not_enough_evers);
+        if (WRAPPERS_CFG_CLONE_WINDOW > 0 && wics.size() == wic_count.get()) {
+          // Fan-out upgrade: old WICs are cloned in parallel and report to onWICCloned
+          clone_evers_ = evers;
+          clone_src_ = wics;
+          while (clone_sent_ < wic_count && clone_in_flight_.get() < WRAPPERS_CFG_CLONE_WINDOW)
+            request_wic_clone(*this);
+          return;
+        }
         IWICPtr(*first_wic)(_all_except(keep_evers)).cloneUpgrade(evers, {}, {}, {}, {}, token_version_, tvm_myaddr(), wrapper_deployers_);
         last_wic_ = last_wic; // We are waiting onWICsCloned from this old last_wic
       }
@@ -89,6 +100,14 @@ public:
     tvm_transfer(getConfig().super_root, 0, true, SEND_ALL_GAS | IGNORE_ACTION_ERRORS);
   }
 
+  void onWICCloned(
+    uint32       idx,
+    opt<address> clone
+  ) {
+    check_wic_clone_answer(*this, idx, int_sender());
+    wic_clone_done(*this, idx, clone);
+  }
+
   void addWrapperType(
     uint128 keep_evers,
     uint8   type,
@@ -123,6 +142,7 @@ public:
       wic.deploy(init, Evers(evers.deploy.get())).onDeploy(evers.wic_keep, {}, {}, false, deployer, type, init_args);
       first_wic_ = wic.get();
       last_wic_ = wic.get();
+      wics_.set_at(0u32, wic.get());
       wic_count_ = 1;
     } else {
       auto [init, hash] = prepare<IWIC>(DWIC{.symbol_=symbol}, salted_wic_code);
@@ -130,6 +150,7 @@ public:
       wic.deploy(init, Evers(evers.deploy.get())).onDeploy(evers.wic_keep, {}, {}, false, deployer, type, init_args);
       IWICPtr(*last_wic_)(Evers(evers.setnext.get())).setNext({}, {}, wic.get());
       last_wic_ = wic.get();
+      wics_.set_at(wic_count_, wic.get());
       ++wic_count_;
     }
 
@@ -160,7 +181,7 @@ public:
     IWrappersConfigPtr clone(address::make_std(workchain_id_, hash));
     tvm_rawreserve(keep_evers.get(), rawreserve_flag::up_to);
     clone.deploy(init, Evers(clone_deploy_evers.get())).
-      onDeploy(keep_evers, evers, token_version_, wrapper_deployers, first_wic_, last_wic_, wic_count_);
+      onDeploy(keep_evers, evers, token_version_, wrapper_deployers, first_wic_, last_wic_, wic_count_, wics_);
 
     // to send answer to the original caller (caller->SuperRoot->WrappersConfig->caller)
     if (answer_addr)
@@ -183,6 +204,77 @@ public:
     return parse_chain_static<WrappersConfigSalt>(parser(tvm_code_salt()));
   }
 
+  /// Fan-out upgrade: request the next old WIC to clone itself
+  static void request_wic_clone(DWrappersConfig &d) {
+    auto evers = *d.clone_evers_;
+    IWICPtr(*d.clone_src_.lookup(d.clone_sent_))(Evers((evers.deploy + evers.setnext + evers.wic_keep).get())).
+      cloneUpgradeIdx(d.clone_sent_, evers, d.token_version_, tvm_myaddr(), d.wrapper_deployers_);
+    ++d.clone_sent_;
+    ++d.clone_in_flight_;
+  }
+
+  /// Fan-out upgrade: check that the answer for old WIC `idx` is expected from `sender`
+  static void check_wic_clone_answer(DWrappersConfig &d, uint32 idx, address sender) {
+    auto old_wic = d.clone_src_.lookup(idx);
+    require(d.clone_evers_ && old_wic && sender == *old_wic && idx >= d.clone_linked_ && idx < d.clone_sent_ &&
+            !d.clone_done_.contains(idx), error_code::unexpected_callback);
+  }
+
+  /// Fan-out upgrade: old WIC `idx` is processed (`clone` is empty for unlisted or failed WIC)
+  static void wic_clone_done(DWrappersConfig &d, uint32 idx, opt<address> clone) {
+    auto evers = *d.clone_evers_;
+    d.clone_done_.set_at(idx, clone);
+    --d.clone_in_flight_;
+    // Linking clones in the old index order, so the new list and index keep the listing order
+    while (auto next = d.clone_done_.extract(d.clone_linked_)) {
+      if (*next) {
+        if (d.last_wic_)
+          IWICPtr(*d.last_wic_)(Evers(evers.setnext.get())).setNext({}, {}, **next);
+        else
+          d.first_wic_ = **next;
+        d.last_wic_ = **next;
+        d.wics_.set_at(d.wic_count_, **next);
+        ++d.wic_count_;
+      }
+      ++d.clone_linked_;
+    }
+    if (d.clone_sent_.get() < d.clone_src_.size())
+      request_wic_clone(d);
+    if (d.clone_linked_.get() < d.clone_src_.size())
+      return;
+
+    // All WICs are cloned
+    d.clone_evers_.reset();
+    d.clone_src_ = {};
+    tvm_rawreserve(d.keep_evers_.get(), rawreserve_flag::up_to);
+    auto cfg = parse_chain_static<WrappersConfigSalt>(parser(tvm_code_salt()));
+    tvm_transfer(cfg.super_root, 0, true, SEND_ALL_GAS | IGNORE_ACTION_ERRORS);
+  }
+
+  // received bounced message back
+  __attribute__((noinline))
+  static int _on_bounced(cell msg, slice msg_body) {
+    tvm_accept();
+
+    parser p(msg_body);
+    require(p.ldi(32) == -1, error_code::wrong_bounced_header);
+    auto [opt_hdr, =p] = parse_continue<abiv2::internal_msg_header>(p);
+    require(!!opt_hdr, error_code::wrong_bounced_header);
+    // Only fan-out clone requests are processed: old WIC failed to clone itself and is skipped
+    if (opt_hdr->function_id != id_v<&IWIC::cloneUpgradeIdx>)
+      return 0;
+    auto idx = parse<uint32>(p, error_code::wrong_bounced_args);
+    auto parsed_msg = parse<int_msg_info>(parser(msg), error_code::wrong_bounced_header);
+    auto sender = incoming_msg(parsed_msg).int_sender();
+
+    auto [hdr, persist] = load_persistent_data<IWrappersConfig, void, DWrappersConfig>();
+    check_wic_clone_answer(persist, idx, sender);
+    persist.clone_failed_.set_at(idx, sender);
+    wic_clone_done(persist, idx, {});
+    save_persistent_data<IWrappersConfig, void>(hdr, persist);
+    return 0;
+  }
+
   static std::pair<uint256, uint16> my_code_hash_and_depth() {
     cell cl = tvm_mycode();
     return { uint256(tvm_hash(cl)), uint16(cl.cdepth()) };
@@ -66,6 +66,16 @@ digraph wic_upgrade {
  deployer -> flx2_wrapper [ color=lightgray ];
 }
 @enddot
+ *  \section fanout Fan-out upgrade
+ *  If WRAPPERS_CFG_CLONE_WINDOW > 0 and the old WrappersConfig has full WIC index (`wics_`),
+ *   the new WrappersConfig sends IWIC::cloneUpgradeIdx directly to old WICs, keeping up to WRAPPERS_CFG_CLONE_WINDOW
+ *   of them in flight. Each old WIC deploys its clone and reports IWrappersConfig::onWICCloned(idx, clone).
+ *  The new WrappersConfig links clones in the old index order (unlisted WICs are skipped) and builds the new index.
+ *  If cloneUpgradeIdx bounces (old WIC failed or not exists), the WIC is skipped and kept in `clone_failed_`
+ *   to be re-added by SuperRoot owner with addWrapper.
+ *  WrappersConfig and WIC codes are not changed by cloneUpgrade, so fan-out works for every clone
+ *   of a WrappersConfig line deployed with this code (its `wics_` index is always full).
+ *  Older WrappersConfig lines (without `wics_`) keep the chained upgrade.
 **/
 
 #pragma once
@@ -74,8 +84,15 @@ digraph wic_upgrade {
 #include <tvm/smart_switcher.hpp>
 #include <tvm/contract_handle.hpp>
 #include <tvm/replay_attack_protection/timestamp.hpp>
+#include <tvm/small_dict_map.hpp>
 #include "WICCloneEvers.hpp"
 
+/// Fan-out upgrade window (old WICs being cloned in parallel). 0 means chained upgrade through WICs.
+/// Every cloneUpgradeIdx request sends a message, so the window must be well below the action list limit (255).
+#ifndef WRAPPERS_CFG_CLONE_WINDOW
+#define WRAPPERS_CFG_CLONE_WINDOW 16
+#endif
+
 namespace tvm {
 
 /// WrappersConfig configuration in code salt
@@ -116,7 +133,8 @@ __interface IWrappersConfig {
     dict_array<address> wrapper_deployers, ///< Wrapper deployers (empty for original deploy)
     address_opt         first_wic,         ///< First WIC of the previous WrappersConfig (empty for original deploy)
     address_opt         last_wic,          ///< Last WIC of the previous WrappersConfig (empty for original deploy)
-    uint32              wic_count          ///< WIC count
+    uint32              wic_count,         ///< WIC count
+    small_dict_map<uint32, address> wics   ///< WIC index of the previous WrappersConfig (empty for original deploy)
   );
 
   /// Notification from last WIC (old) about completion of WICs cloning procedure to the new WrappersConfig
@@ -127,6 +145,13 @@ __interface IWrappersConfig {
     uint32      wic_count  ///< WIC count
   );
 
+  /// Notification from old WIC about its clone in fan-out upgrade
+  [[internal]]
+  void onWICCloned(
+    uint32       idx,  ///< Index of the old WIC
+    opt<address> clone ///< Cloned WIC (empty if the old WIC is unlisted)
+  );
+
   /// Add Wrapper type
   [[internal]]
   void addWrapperType(
@@ -186,6 +211,14 @@ struct DWrappersConfig {
   address_opt         last_wic_;          ///< Last Wrapper Index Contract. May be set when first_wic_ is unset -
                                           ///<  it means we are waiting onWICsCloned callback from this old last_wic_.
   uint32              wic_count_;         ///< WIC count
+  small_dict_map<uint32, address> wics_;  ///< WIC index: sequential id in [0, wic_count_) -> WIC
+  opt<WICCloneEvers>  clone_evers_;       ///< Evers configuration for each WIC clone (for fan-out upgrade)
+  small_dict_map<uint32, address>      clone_src_;  ///< Old WICs index (for fan-out upgrade)
+  small_dict_map<uint32, opt<address>> clone_done_; ///< Received clones, not linked yet (for fan-out upgrade)
+  uint32              clone_sent_;        ///< Old WICs requested to clone (for fan-out upgrade)
+  uint32              clone_in_flight_;   ///< Old WICs requested but not answered yet (for fan-out upgrade)
+  uint32              clone_linked_;      ///< Old WICs linked in the new list (for fan-out upgrade)
+  small_dict_map<uint32, address> clone_failed_; ///< Old WICs with bounced cloneUpgradeIdx (for fan-out upgrade)
 };
 
 /// \interface EWrappersConfig
@@ -0,0 +1,95 @@
+/** \file
+ *  \brief Compile-time gas checkpoints for hot paths profiling.
+ *
+ *  Build with `-DFLEX_GAS_PROFILE` to compile `FLEX_GAS_CHECKPOINT(stage)` macros into the contracts.
+ *  Each checkpoint sends an external outbound message (no destination) with the stage id
+ *   and the gas remaining at this stage. Gas consumed by a stage is the difference of
+ *   `gas_remaining` of the previous and the current checkpoint in the same transaction.
+ *  Without the flag the macros are empty and the contract code is unchanged.
+ *
+ *  TVM versions differ in the gas meter instruction, so the profiling build also requires
+ *   `FLEX_GAS_REMAINING()` macro to be defined for the target toolchain.
+ *  \author Andrew Zhogin
+ *  \copyright 2019-2022 (c) EverFlex Inc
+ */
+
+#pragma once
+
+/// Checkpoint stage ids. High byte is the contract: 1 - PriceXchg, 2 - FlexWallet, 3 - FlexClient.
+namespace tvm { namespace gas_stage {
+
+static constexpr unsigned xchg_lend_entry       = 0x0101; ///< PriceXchg::onTip3LendOwnership start
+static constexpr unsigned xchg_lend_parsed      = 0x0102; ///< Salt config and payload parsed
+static constexpr unsigned xchg_lend_verified    = 0x0103; ///< Order checks done (including tip3 wallet address hashing)
+static constexpr unsigned xchg_lend_enqueued    = 0x0104; ///< Order pushed into queue, onXchgOrderAdded sent
+static constexpr unsigned xchg_lend_matched     = 0x0105; ///< Matching done (process_queue_impl, including finalize)
+static constexpr unsigned xchg_lend_done        = 0x0106; ///< Queues stored, registration synced
+static constexpr unsigned xchg_queue_entry      = 0x0111; ///< PriceXchg::processQueue start
+static constexpr unsigned xchg_queue_matched    = 0x0112; ///< Matching done (process_queue_impl, including finalize)
+
+static constexpr unsigned wallet_transfer_entry = 0x0201; ///< TONTokenWallet::transferToRecipient start
+static constexpr unsigned wallet_transfer_sent  = 0x0202; ///< Destination wallet calculated, acceptTransfer sent
+static constexpr unsigned wallet_accept_entry   = 0x0211; ///< TONTokenWallet::acceptTransfer start
+static constexpr unsigned wallet_accept_checked = 0x0212; ///< Sender wallet address verified
+static constexpr unsigned wallet_accept_done    = 0x0213; ///< Notification or evers return sent
+
+static constexpr unsigned client_order_entry    = 0x0301; ///< FlexClient::deployPriceXchg start
+static constexpr unsigned client_order_sent     = 0x0302; ///< makeOrder sent to FlexWallet
+static constexpr unsigned client_order_done     = 0x0303; ///< PriceXchg address calculated
+
+}} // namespace tvm::gas_stage
+
+#ifdef FLEX_GAS_PROFILE
+
+#ifndef FLEX_GAS_REMAINING
+#error "Macros FLEX_GAS_REMAINING() must be defined for FLEX_GAS_PROFILE build (gas remaining primitive of the target TVM)"
+#endif
+
+#include <tvm/schema/basics.hpp>
+#include <tvm/schema/build_chain_static.hpp>
+
+namespace tvm { namespace gas_profile {
+
+static constexpr unsigned magic = 0x47415350; ///< "GASP", to filter checkpoints from other external messages
+
+/// Checkpoint external outbound message (ext_out_msg_info with inlined body)
+struct checkpoint_msg {
+  uint_t<2> info_tag;      ///< ext_out_msg_info$11
+  uint_t<2> src;           ///< addr_none$00, replaced by the contract address
+  uint_t<2> dest;          ///< addr_none$00
+  uint64    created_lt;    ///< Filled by TVM
+  uint32    created_at;    ///< Filled by TVM
+  uint_t<1> has_init;      ///< No StateInit
+  uint_t<1> body_in_ref;   ///< Body is inlined
+  uint32    magic;         ///< gas_profile::magic
+  uint32    stage;         ///< Stage id (tvm::gas_stage)
+  uint64    gas_remaining; ///< Gas remaining at the stage
+};
+
+__always_inline
+void checkpoint(unsigned stage) {
+  checkpoint_msg msg {
+    .info_tag      = 3,
+    .src           = 0,
+    .dest          = 0,
+    .created_lt    = 0,
+    .created_at    = 0,
+    .has_init      = 0,
+    .body_in_ref   = 0,
+    .magic         = magic,
+    .stage         = stage,
+    .gas_remaining = static_cast<unsigned>(FLEX_GAS_REMAINING())
+  };
+  // Profiling must not break the transaction, so action errors (e.g. out of balance after SEND_ALL_GAS) are ignored
+  tvm_sendmsg(build_chain_static(msg), IGNORE_ACTION_ERRORS);
+}
+
+}} // namespace tvm::gas_profile
+
+#define FLEX_GAS_CHECKPOINT(stage) ::tvm::gas_profile::checkpoint(::tvm::gas_stage::stage)
+
+#else // FLEX_GAS_PROFILE
+
+#define FLEX_GAS_CHECKPOINT(stage)
+
+#endif // FLEX_GAS_PROFILE
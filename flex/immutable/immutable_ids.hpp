@@ -10,6 +10,8 @@ constexpr unsigned flex_on_deploy_id = 0x100;
 constexpr unsigned flex_register_xchg_pair_id = 0x200;
 /// IFlex::requestPairs func id
 constexpr unsigned flex_request_pairs_id = 0x300;
+/// IFlex::requestPairsPage func id
+constexpr unsigned flex_request_pairs_page_id = 0x400;
 
 /// IWrapper::getDetails func id
 constexpr unsigned wrapper_get_details_id = 0x100;
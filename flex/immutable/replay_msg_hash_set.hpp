@@ -0,0 +1,110 @@
+/** \file
+ *  \brief Replay attack protection with a set of recently accepted message hashes.
+ *
+ *  Alternative to `replay_attack_protection::timestamp<Interval>` for high-throughput external callers.
+ *  `timestamp<>` requires every next message time to be greater than the previous one,
+ *   so a burst of messages from one key is serialized and out-of-order messages are rejected.
+ *  `msg_hash_set<>` accepts any message with time inside (now - Interval, now + Interval) window
+ *   if the same message (body hash) was not accepted before.
+ *  A replay of a message older than the window is rejected by the window check,
+ *   so the set only has to keep the messages inside the window.
+ *  The check runs before tvm_accept, so its cost is bounded:
+ *   at most \p PurgePerCheck expired entries are purged per call and the set size is a stored counter.
+ *  The static interface is the same as in `timestamp<>`: persistent_t, init() and check().
+ *  The message hash is stored by MAIN_ENTRY_FUNCTIONS_REPLAY main_external before smart_switch.
+ *  \author Andrew Zhogin
+ *  \copyright 2019-2022 (c) EverFlex Inc
+ */
+
+#pragma once
+
+#include <tvm/schema/basics.hpp>
+#include <tvm/small_dict_map.hpp>
+#include <tvm/smart_switcher.hpp>
+
+namespace tvm { namespace replay_attack_protection {
+
+/// Global id of the incoming external message hash.
+/// The last c7 global slot, the library globals (global_id) are allocated from the first slots.
+static constexpr global_id msg_hash_global = static_cast<global_id>(254);
+
+/// Store hash of the incoming external message body (signature included) for msg_hash_set::check()
+__always_inline void store_msg_hash(__tvm_slice msg_body) {
+  temporary_data::setglob(msg_hash_global, __builtin_tvm_hashsu(msg_body));
+}
+
+/// Hash of the incoming external message body, stored by store_msg_hash()
+__always_inline uint256 stored_msg_hash() {
+  return uint256(temporary_data::getglob(msg_hash_global));
+}
+
+template<unsigned Interval, unsigned MaxMsgs, unsigned PurgePerCheck = 4>
+class msg_hash_set {
+public:
+  static constexpr unsigned interval_sec    = Interval;      ///< Accepted window half-width (in seconds)
+  static constexpr unsigned max_msgs        = MaxMsgs;       ///< Maximum stored messages
+  static constexpr unsigned purge_per_check = PurgePerCheck; ///< Maximum expired messages purged per check
+
+  /// Accepted message key. Message time goes first, so the dict is sorted by time.
+  struct msg_key {
+    uint64  msg_time; ///< Message time (in milliseconds)
+    uint256 msg_hash; ///< Message body hash
+  };
+
+  /// Accepted messages inside the window
+  struct persistent_t {
+    small_dict_map<msg_key, bool_t> accepted;
+    uint16                          count; ///< Number of elements in `accepted`
+  };
+
+  static persistent_t init() {
+    return {};
+  }
+
+  /// Returns updated persistent state if the current message is acceptable, empty otherwise
+  __always_inline
+  static std::optional<persistent_t> check(uint64 msg_time, persistent_t stored) {
+    unsigned now_ms    = static_cast<unsigned>(tvm_now()) * 1000;
+    unsigned window_ms = Interval * 1000;
+    unsigned time_ms   = msg_time.get();
+    if (time_ms + window_ms <= now_ms || time_ms >= now_ms + window_ms)
+      return {};
+    // Purging a few expired messages from the oldest side
+    for (unsigned i = 0; i < PurgePerCheck && stored.count > 0; ++i) {
+      auto oldest = (*stored.accepted.begin()).first;
+      if (oldest.msg_time.get() + window_ms > now_ms)
+        break;
+      stored.accepted.erase(oldest);
+      --stored.count;
+    }
+    msg_key key { msg_time, stored_msg_hash() };
+    if (stored.count >= MaxMsgs || stored.accepted.contains(key))
+      return {};
+    stored.accepted.set_at(key, bool_t(true));
+    ++stored.count;
+    return stored;
+  }
+};
+
+}} // namespace tvm::replay_attack_protection
+
+/// Main entry functions with the provided replay attack protection policy.
+/// For policies which are not covered by DEFAULT_MAIN_ENTRY_FUNCTIONS (timestamp<Interval>).
+#define MAIN_ENTRY_FUNCTIONS_REPLAY(Contract, IContract, DContract, ReplayProtection)                \
+__attribute__((tvm_raw_func)) int main_external(__tvm_cell msg, __tvm_slice msg_body) {             \
+  replay_attack_protection::store_msg_hash(msg_body);                                                \
+  return smart_switch<false, Contract, IContract, DContract, ReplayProtection>(msg, msg_body);        \
+}                                                                                                    \
+__attribute__((tvm_raw_func)) int main_internal(__tvm_cell msg, __tvm_slice msg_body) {             \
+  return smart_switch<true, Contract, IContract, DContract, ReplayProtection>(msg, msg_body);         \
+}
+
+/// The same for template contracts with `Internal` parameter (like TONTokenWallet<Internal>).
+#define MAIN_ENTRY_FUNCTIONS_REPLAY_TMPL(Contract, IContract, DContract, ReplayProtection)           \
+__attribute__((tvm_raw_func)) int main_external(__tvm_cell msg, __tvm_slice msg_body) {             \
+  replay_attack_protection::store_msg_hash(msg_body);                                                \
+  return smart_switch<false, Contract<false>, IContract, DContract, ReplayProtection>(msg, msg_body); \
+}                                                                                                    \
+__attribute__((tvm_raw_func)) int main_internal(__tvm_cell msg, __tvm_slice msg_body) {             \
+  return smart_switch<true, Contract<true>, IContract, DContract, ReplayProtection>(msg, msg_body);   \
+}
@@ -0,0 +1,31 @@
+# Code size checks of the contracts directory (included by immutable/tokens/exchange/ui Makefiles).
+# Code cells are loaded in every transaction, so code growth is paid in gas by every call.
+#  check_size          - fails if a contract is bigger than 16000 bytes
+#  check_size_baseline - fails if a contract is bigger than in size.baseline ("<contract>.tvc <bytes>" per line)
+#  size_baseline       - regenerates size.baseline after an intended code size change
+#  size_delta          - per-contract size change against size.baseline (to be attached to an upgrade),
+#                        contracts missing in the baseline or in the build are reported as 0 size there
+# size.baseline must come from a real build of the current sources (make size_baseline),
+#  check_size_baseline is not a part of `all` until the baselines are committed.
+
+SIZE_BASELINE := size.baseline
+
+.PHONY: check_size check_size_baseline size_baseline size_delta
+
+check_size: tvcs
+	@ls -l *.tvc | awk '{ if ($$5 > 16000) { print ${RED} "CONTRACT BIG SIZE" ${CLEAR} " | " $$5 " | " $$9; err = 1; } } END {exit err}'
+
+check_size_baseline: tvcs
+	@if [ ! -f $(SIZE_BASELINE) ]; then echo "No $(SIZE_BASELINE) in $(CURDIR), run 'make size_baseline'"; exit 1; fi; \
+	ls -l *.tvc | awk 'NR == FNR { base[$$1] = $$2; next } \
+	  ($$9 in base) && ($$5 > base[$$9]) { print ${RED} "CONTRACT SIZE REGRESSION" ${CLEAR} " | " base[$$9] " -> " $$5 " | " $$9; err = 1; } \
+	  END {exit err}' $(SIZE_BASELINE) -
+
+size_baseline: tvcs
+	@ls -l *.tvc | awk '{ print $$9 " " $$5 }' > $(SIZE_BASELINE)
+
+size_delta: tvcs
+	@if [ ! -f $(SIZE_BASELINE) ]; then echo "No $(SIZE_BASELINE) in $(CURDIR), run 'make size_baseline'"; exit 1; fi; \
+	ls -l *.tvc | awk 'NR == FNR { base[$$1] = $$2; next } \
+	  { old = ($$9 in base) ? base[$$9] : 0; delete base[$$9]; printf "%-28s %6d -> %6d | %+d\n", $$9, old, $$5, $$5 - old } \
+	  END { for (name in base) printf "%-28s %6d -> %6d | %+d\n", name, base[name], 0, -base[name] }' $(SIZE_BASELINE) -
@@ -27,7 +27,7 @@
 using namespace tvm;
 using namespace schema;
 
-template<bool Internal>
+template<bool Internal, class WalletReplayProtection = wallet_replay_protection_t>
 class RootTokenContract final : public smart_interface<IRootTokenContract>, public DRootTokenContract {
 public:
   using data = DRootTokenContract;
@@ -269,7 +269,7 @@ private:
                           uint256(wallet_hash), uint16(wallet_code_depth),
                           workchain_id());
 
-    auto [wallet_init, dest_addr] = prepare_wallet_state_init_and_addr(wallet_data, wallet_code_.get());
+    auto [wallet_init, dest_addr] = prepare_wallet_state_init_and_addr<WalletReplayProtection>(wallet_data, wallet_code_.get());
     address dest = address::make_std(workchain_id(), dest_addr);
     return { wallet_init, dest };
   }
@@ -301,5 +301,12 @@ private:
 DEFINE_JSON_ABI(IRootTokenContract, DRootTokenContract, ERootTokenContract, root_replay_protection_t);
 
 // ----------------------------- Main entry functions ---------------------- //
+#ifdef TIP3_WALLET_BURST
+// Deploys TONTokenWalletBurst wallets
+template<bool Internal>
+using RootTokenContractBurst = RootTokenContract<Internal, wallet_burst_replay_protection_t>;
+DEFAULT_MAIN_ENTRY_FUNCTIONS_TMPL(RootTokenContractBurst, IRootTokenContract, DRootTokenContract, ROOT_TIMESTAMP_DELAY)
+#else
 DEFAULT_MAIN_ENTRY_FUNCTIONS_TMPL(RootTokenContract, IRootTokenContract, DRootTokenContract, ROOT_TIMESTAMP_DELAY)
+#endif
 
@@ -23,6 +23,7 @@
 #include <tvm/schema/build_chain_static.hpp>
 
 #include "FlexLendPayloadArgs.hpp"
+#include "gas_profile.hpp"
 
 using namespace tvm;
 
@@ -38,13 +39,14 @@ struct auth_cfg {
 };
 
 /// Implementation of TONTokenWallet contract
-template<bool Internal>
+template<bool Internal, class ReplayProtection = wallet_replay_protection_t>
 class TONTokenWallet final : public smart_interface<ITONTokenWallet>, public DTONTokenWallet {
 public:
   using data = DTONTokenWallet;
-  DEFAULT_SUPPORT_FUNCTIONS(ITONTokenWallet, wallet_replay_protection_t)
+  using replay_protection_t = ReplayProtection;
+  DEFAULT_SUPPORT_FUNCTIONS(ITONTokenWallet, replay_protection_t)
 
-  static constexpr unsigned min_transfer_costs = 150000000; ///< Minimum transfer costs in evers
+  static constexpr unsigned min_transfer_costs = tip3_min_transfer_costs; ///< Minimum transfer costs in evers
   static constexpr unsigned c_max_lend_owners  = 50;        ///< Limit of lend owners
 
   /// Error codes of TONTokenWallet contract
@@ -95,6 +97,7 @@ public:
     uint128     return_ownership,
     opt<cell>   notify_payload
   ) {
+    FLEX_GAS_CHECKPOINT(wallet_transfer_entry);
     // performing `tail call` - requesting dest to answer to our caller
     temporary_data::setglob(global_id::answer_id, return_func_id()->get());
     transfer_to_recipient_impl(answer_addr, to.pubkey, to.owner,
@@ -122,11 +125,7 @@ public:
     if (reserve_balance > 0)
       tvm_rawreserve(reserve_balance, rawreserve_flag::up_to);
     if (notify_payload && owner_address_) {
-      // performing `tail call` - requesting dest to answer to our caller
-      temporary_data::setglob(global_id::answer_id, return_func_id()->get());
-      ITONTokenWalletNotifyPtr(*owner_address_)(Evers(0), SEND_ALL_GAS).
-        onTip3Transfer(balance_, _value, evers_balance, {name_, symbol_, decimals_, root_pubkey_, root_address_},
-                       {}, {wallet_pubkey_, owner_address_}, *notify_payload, answer_addr);
+      notify_owner(_value, evers_balance, {}, *notify_payload, answer_addr);
     } else {
       // IGNORE_ACTION_ERRORS in case when we want to keep all evers here and return message will fail
       if (answer_addr != tvm_myaddr())
@@ -135,17 +134,20 @@ public:
   }
 
   void acceptTransfer(
-    uint128     _value,
-    address     answer_addr,
-    uint128     keep_evers,
-    uint256     sender_pubkey,
-    address_opt sender_owner,
-    opt<cell>   notify_payload
+    uint128      _value,
+    address      answer_addr,
+    uint128      keep_evers,
+    uint256      sender_pubkey,
+    address_opt  sender_owner,
+    opt<cell>    notify_payload,
+    opt<uint256> settlement
   ) {
+    FLEX_GAS_CHECKPOINT(wallet_accept_entry);
     uint256 expected_addr = expected_address(sender_pubkey, sender_owner);
     auto [sender, value] = int_sender_and_value();
     require(std::get<addr_std>(sender()).address == expected_addr,
             error_code::message_sender_is_not_good_wallet);
+    FLEX_GAS_CHECKPOINT(wallet_accept_checked);
     balance_ += _value;
 
     auto reserve_balance = tvm_balance() + static_cast<int>(keep_evers.get()) - static_cast<int>(value());
@@ -154,18 +156,15 @@ public:
       tvm_rawreserve(reserve_balance, rawreserve_flag::up_to);
 
     // If notify_receiver is specified, we send notification to the internal owner
-    if (notify_payload && owner_address_) {
-      // performing `tail call` - requesting dest to answer to our caller
-      temporary_data::setglob(global_id::answer_id, return_func_id()->get());
-      ITONTokenWalletNotifyPtr(*owner_address_)(Evers(0), SEND_ALL_GAS).
-        onTip3Transfer(balance_, _value, evers_balance, {name_, symbol_, decimals_, root_pubkey_, root_address_},
-                       Tip3Creds{sender_pubkey, sender_owner}, {wallet_pubkey_, owner_address_},
-                       *notify_payload, answer_addr);
+    //  (unless it is a settlement and the owner asked to skip them)
+    if (notify_payload && owner_address_ && !skip_owner_notify(settlement)) {
+      notify_owner(_value, evers_balance, Tip3Creds{sender_pubkey, sender_owner}, *notify_payload, answer_addr);
     } else {
       // In some cases, answer_addr may be this contract
       if (answer_addr != address{tvm_myaddr()})
         tvm_transfer(answer_addr, 0, false, SEND_ALL_GAS);
     }
+    FLEX_GAS_CHECKPOINT(wallet_accept_done);
   }
 
   void destroy(address dest) {
@@ -252,7 +251,8 @@ public:
       .sells_amount_ = 0u128,
       .buys_amount_  = 0u128,
       .sells_ = {},
-      .buys_  = {}
+      .buys_  = {},
+      .stats_ = {}
     };
     auto [state_init, std_addr] = prepare<IPriceXchg>(price_data, salted_price_code);
     auto dest = address::make_std(workchain_id_, std_addr);
@@ -273,7 +273,7 @@ public:
       sum_lend_finish_time = std::max(lend_finish_time, existing_lend->lend_finish_time);
     }
 
-    lend_owners_.set_at({dest}, {sum_lend_balance, sum_lend_finish_time});
+    lend_owners_.set_at({dest}, {sum_lend_balance, sum_lend_finish_time, {}, calc_binding_hash(*binding_)});
 
     unsigned msg_flags = prepare_transfer_message_flags(evers);
 
@@ -311,22 +311,28 @@ public:
       .allowed_lend_owner                       = true
     });
 
-    auto sender = int_sender();
-    auto v = lend_owners_.extract({sender});
-    require(!!v, error_code::lend_owner_not_found);
-    tokens = std::min(tokens, v->lend_balance);
+    return_ownership_impl(tokens);
+  }
 
-    if (v->lend_balance > tokens) {
-      v->lend_balance -= tokens;
-      lend_owners_.set_at({sender}, *v);
-    }
+  void onOrderFinishedReturn(
+    [[maybe_unused]] OrderRet ret,
+    uint128 return_tokens
+  ) {
+    check_owner({
+      .allowed_for_original_owner_in_lend_state = false,
+      .allowed_lend_pubkey                      = false,
+      .allowed_lend_owner                       = true
+    });
+    // `ret` is carried for off-chain order tracking, the same way as in IPriceCallback::onOrderFinished
+    return_ownership_impl(return_tokens);
   }
 
   void bind(
     bool           set_binding,
     opt<bind_info> binding,
     bool           set_trader,
-    opt<uint256>   trader
+    opt<uint256>   trader,
+    opt<uint8>     notify_policy
   ) {
     check_owner({
       .allowed_for_original_owner_in_lend_state = true,
@@ -337,6 +343,8 @@ public:
       binding_ = binding;
     if (set_trader)
       lend_pubkey_ = trader;
+    if (notify_policy)
+      notify_policy_ = *notify_policy;
   }
 #endif // TIP3_ENABLE_LEND_OWNERSHIP
 
@@ -347,8 +355,13 @@ public:
   // =============================== getters =============================== //
   details_info getDetails() {
     auto [filtered_lend_owners, lend_balance] = filter_lend_array();
-    return { name_, symbol_, decimals_,
+    return {
+#ifdef TIP3_ENABLE_LEND_OWNERSHIP
+             balance_, root_address_,
+#else
+             name_, symbol_, decimals_,
              balance_, root_pubkey_, root_address_,
+#endif
              wallet_pubkey_, owner_address_,
              getLendPubkey(), filtered_lend_owners, lend_balance, getBinding(),
              code_hash_, code_depth_, workchain_id_ };
@@ -380,7 +393,7 @@ public:
     require(!!opt_hdr, error_code::wrong_bounced_header);
 
     // other cases require load/store of persistent data
-    auto [hdr, persist] = load_persistent_data<ITONTokenWallet, wallet_replay_protection_t, DTONTokenWallet>();
+    auto [hdr, persist] = load_persistent_data<ITONTokenWallet, replay_protection_t, DTONTokenWallet>();
 
     // If it is bounced onTip3LendOwnership, then we need to reset lend ownership
 #ifdef TIP3_ENABLE_LEND_OWNERSHIP
@@ -419,7 +432,7 @@ public:
       auto bounced_val = parse<uint128>(p, error_code::wrong_bounced_args);
       persist.balance_ += bounced_val;
     }
-    save_persistent_data<ITONTokenWallet, wallet_replay_protection_t>(hdr, persist);
+    save_persistent_data<ITONTokenWallet, replay_protection_t>(hdr, persist);
     return 0;
   }
 
@@ -432,8 +445,25 @@ public:
     return 0;
   }
 private:
+#ifdef TIP3_ENABLE_LEND_OWNERSHIP
+  /// Release lend ownership of the sender for \p tokens
+  void return_ownership_impl(uint128 tokens) {
+    auto sender = int_sender();
+    auto v = lend_owners_.extract({sender});
+    require(!!v, error_code::lend_owner_not_found);
+    tokens = std::min(tokens, v->lend_balance);
+
+    if (v->lend_balance > tokens) {
+      v->lend_balance -= tokens;
+      lend_owners_.set_at({sender}, *v);
+    }
+  }
+#endif // TIP3_ENABLE_LEND_OWNERSHIP
+
   void transfer_impl(address_opt answer_addr, address to, uint128 tokens, uint128 evers,
                      uint128 return_ownership, opt<cell> notify_payload) {
+    // Must be calculated before check_transfer_requires, which may remove the exhausted lend record of the sender
+    auto settlement = lend_owner_settlement();
     check_transfer_requires(tokens, evers, return_ownership);
     // Transfer to zero address is not allowed.
     require(std::get<addr_std>(to()).address != 0, error_code::transfer_to_zero_address);
@@ -444,7 +474,7 @@ private:
     unsigned msg_flags = prepare_transfer_message_flags(evers);
     ITONTokenWalletPtr dest_wallet(to);
     dest_wallet(Evers(evers.get()), msg_flags).
-      acceptTransfer(tokens, answer_addr_fxd, 0u128, wallet_pubkey_, owner_address_, notify_payload);
+      acceptTransfer(tokens, answer_addr_fxd, 0u128, wallet_pubkey_, owner_address_, notify_payload, settlement);
     update_spent_balance(tokens);
   }
 
@@ -452,6 +482,8 @@ private:
                                   uint256 recipient_pubkey, address_opt recipient_owner,
                                   uint128 tokens, uint128 evers, uint128 keep_evers, bool deploy,
                                   uint128 return_ownership, opt<cell> notify_payload) {
+    // Must be calculated before check_transfer_requires, which may remove the exhausted lend record of the sender
+    auto settlement = lend_owner_settlement();
     check_transfer_requires(tokens, evers, return_ownership);
     tvm_accept();
 
@@ -462,14 +494,45 @@ private:
     ITONTokenWalletPtr dest_wallet(dest);
     if (deploy) {
       dest_wallet.deploy(wallet_init, Evers(evers.get()), msg_flags).
-        acceptTransfer(tokens, answer_addr_fxd, keep_evers, wallet_pubkey_, owner_address_, notify_payload);
+        acceptTransfer(tokens, answer_addr_fxd, keep_evers, wallet_pubkey_, owner_address_, notify_payload, settlement);
     } else {
       dest_wallet(Evers(evers.get()), msg_flags).
-        acceptTransfer(tokens, answer_addr_fxd, keep_evers, wallet_pubkey_, owner_address_, notify_payload);
+        acceptTransfer(tokens, answer_addr_fxd, keep_evers, wallet_pubkey_, owner_address_, notify_payload, settlement);
     }
     update_spent_balance(tokens);
+    FLEX_GAS_CHECKPOINT(wallet_transfer_sent);
+  }
+
+  // Transfer is requested by a lend owner of this wallet (order settlement by PriceXchg).
+  // Returns hash of the binding the lend owner was verified with in makeOrder.
+  opt<uint256> lend_owner_settlement() const {
+#ifdef TIP3_ENABLE_LEND_OWNERSHIP
+    if constexpr (Internal) {
+      if (auto rec = lend_owners_.lookup({int_sender()}))
+        return rec->binding_hash;
+    }
+#endif // TIP3_ENABLE_LEND_OWNERSHIP
+    return {};
+  }
+
+  // Owner notification about settlement may be disabled by notification policy.
+  // Only for settlements by a lend owner verified with the same binding as this wallet has
+  //  (PriceXchg of the bound Flex, not an arbitrary contract of the sender wallet owner).
+  bool skip_owner_notify([[maybe_unused]] opt<uint256> settlement) const {
+#ifdef TIP3_ENABLE_LEND_OWNERSHIP
+    return settlement && binding_ && (notify_policy_ & wallet_notify_policy::skip_settlements) &&
+           *settlement == calc_binding_hash(*binding_);
+#else
+    return false;
+#endif // TIP3_ENABLE_LEND_OWNERSHIP
   }
 
+#ifdef TIP3_ENABLE_LEND_OWNERSHIP
+  static uint256 calc_binding_hash(bind_info binding) {
+    return uint256(tvm_hash(build(binding).endc()));
+  }
+#endif // TIP3_ENABLE_LEND_OWNERSHIP
+
   // If zero answer_addr is specified, it is corrected to incoming sender (for internal message),
   // or this contract address (for external message)
   address fixup_answer_addr(address_opt answer_addr) {
@@ -514,34 +577,50 @@ private:
     balance_ -= tokens;
   }
 
-  uint256 expected_address(uint256 sender_pubkey, address_opt sender_owner) {
-    DTONTokenWallet wallet_data {
-      name_, symbol_, decimals_,
-      0u128, root_pubkey_, root_address_,
-      sender_pubkey, sender_owner,
+  /// Notify internal owner about received tokens.
+  /// FlexWallet (v2) doesn't keep display metadata, so it sends onFlexTip3Transfer with the root address only.
+  void notify_owner(uint128 new_tokens, uint128 evers_balance, opt<Tip3Creds> sender, cell payload, address answer_addr) {
+    // performing `tail call` - requesting dest to answer to our caller
+    temporary_data::setglob(global_id::answer_id, return_func_id()->get());
+    ITONTokenWalletNotifyPtr owner(*owner_address_);
 #ifdef TIP3_ENABLE_LEND_OWNERSHIP
-      {}, {}, {},
+    owner(Evers(0), SEND_ALL_GAS).
+      onFlexTip3Transfer(balance_, new_tokens, evers_balance, root_address_,
+                         sender, {wallet_pubkey_, owner_address_}, lend_pubkey_, binding_, payload, answer_addr);
+#else
+    owner(Evers(0), SEND_ALL_GAS).
+      onTip3Transfer(balance_, new_tokens, evers_balance, {name_, symbol_, decimals_, root_pubkey_, root_address_},
+                     sender, {wallet_pubkey_, owner_address_}, payload, answer_addr);
 #endif
-      code_hash_, code_depth_,
-      workchain_id_
-    };
-    auto init_hdr = persistent_data_header<ITONTokenWallet, wallet_replay_protection_t>::init();
-    cell data_cl = prepare_persistent_data<ITONTokenWallet, wallet_replay_protection_t>(init_hdr, wallet_data);
-    return tvm_state_init_hash(code_hash_, uint256(tvm_hash(data_cl)), code_depth_, uint16(data_cl.cdepth()));
   }
 
-  std::pair<StateInit, address> calc_wallet_init(uint256 pubkey, address_opt owner) {
-    DTONTokenWallet wallet_data {
+  /// Initial persistent data of a wallet from the same root with \p pubkey and \p owner
+  DTONTokenWallet wallet_data_for(uint256 pubkey, address_opt owner) const {
+    return {
+#ifdef TIP3_ENABLE_LEND_OWNERSHIP
+      0u128, root_address_,
+      pubkey, owner,
+      {}, {}, {}, {},
+#else
       name_, symbol_, decimals_,
       0u128, root_pubkey_, root_address_,
       pubkey, owner,
-#ifdef TIP3_ENABLE_LEND_OWNERSHIP
-      {}, {}, {},
 #endif
       code_hash_, code_depth_,
       workchain_id_
     };
-    auto [init, hash] = prepare_wallet_state_init_and_addr(wallet_data, tvm_mycode());
+  }
+
+  uint256 expected_address(uint256 sender_pubkey, address_opt sender_owner) {
+    DTONTokenWallet wallet_data = wallet_data_for(sender_pubkey, sender_owner);
+    auto init_hdr = persistent_data_header<ITONTokenWallet, replay_protection_t>::init();
+    cell data_cl = prepare_persistent_data<ITONTokenWallet, replay_protection_t>(init_hdr, wallet_data);
+    return tvm_state_init_hash(code_hash_, uint256(tvm_hash(data_cl)), code_depth_, uint16(data_cl.cdepth()));
+  }
+
+  std::pair<StateInit, address> calc_wallet_init(uint256 pubkey, address_opt owner) {
+    DTONTokenWallet wallet_data = wallet_data_for(pubkey, owner);
+    auto [init, hash] = prepare_wallet_state_init_and_addr<replay_protection_t>(wallet_data, tvm_mycode());
     return { init, address::make_std(workchain_id_, hash) };
   }
 
@@ -694,10 +773,18 @@ private:
   }
 };
 
+#ifdef TIP3_WALLET_BURST
+template<bool Internal>
+using TONTokenWalletBurst = TONTokenWallet<Internal, wallet_burst_replay_protection_t>;
+DEFINE_JSON_ABI(ITONTokenWallet, DTONTokenWallet, ETONTokenWallet, wallet_burst_replay_protection_t);
+#else
 DEFINE_JSON_ABI(ITONTokenWallet, DTONTokenWallet, ETONTokenWallet, wallet_replay_protection_t);
+#endif
 
 // ----------------------------- Main entry functions ---------------------- //
-#ifdef TIP3_ENABLE_EXTERNAL
+#if defined(TIP3_ENABLE_EXTERNAL) && defined(TIP3_WALLET_BURST)
+MAIN_ENTRY_FUNCTIONS_REPLAY_TMPL(TONTokenWalletBurst, ITONTokenWallet, DTONTokenWallet, wallet_burst_replay_protection_t)
+#elif defined(TIP3_ENABLE_EXTERNAL)
 DEFAULT_MAIN_ENTRY_FUNCTIONS_TMPL(TONTokenWallet, ITONTokenWallet, DTONTokenWallet, TOKEN_WALLET_TIMESTAMP_DELAY)
 #else
 MAIN_ENTRY_FUNCTIONS_NO_REPLAY_TMPL(TONTokenWallet, ITONTokenWallet, DTONTokenWallet)
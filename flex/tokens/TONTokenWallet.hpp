@@ -7,6 +7,19 @@
  *  TIP3_ENABLE_LEND_OWNERSHIP - enable lend ownership functionality.
  *  TIP3_ENABLE_BURN - enable burn functionality, to transfer tokens back through Wrapper.
  *  TIP3_ENABLE_DESTROY - enable destroy method to self-destruct empty wallet.
+ *  TIP3_WALLET_BURST - build TONTokenWallet and RootTokenContract with msg_hash_set replay protection
+ *   (out-of-order messages inside the window are accepted): TONTokenWalletBurst.tvc / RootTokenContractBurst.tvc.
+ *   Only selects the ReplayProtection template argument of these two contracts,
+ *   other contracts calculate wallet addresses with the default wallet_replay_protection_t.
+ *
+ *  FlexWallet (TIP3_ENABLE_LEND_OWNERSHIP) uses v2 identity: its state (and so its address) contains only
+ *  root address, owner pubkey, owner address, code hash/depth and workchain id.
+ *  Display metadata (name, symbol, decimals, root pubkey) is kept by the root (Wrapper).
+ *  Migration from v1 FlexWallet ABI:
+ *  - `details`/`getDetails` don't have name, symbol, decimals and root_pubkey fields,
+ *     take them from the Wrapper `getDetails` (by root_address).
+ *  - Owner notification is `onFlexTip3Transfer` (id 203) with tip3 root address
+ *     instead of `onTip3Transfer` (id 202) with Tip3Config.
  *  \author Andrew Zhogin
  *  \copyright 2019-2022 (c) EverFlex Inc
  */
@@ -18,12 +31,15 @@
 #include <tvm/small_dict_map.hpp>
 
 #include <tvm/replay_attack_protection/timestamp.hpp>
+#include "replay_msg_hash_set.hpp"
 #include <tvm/smart_switcher.hpp>
 #include <tvm/contract_handle.hpp>
 
 #include "FlexLendPayloadArgs.hpp"
+#include "PriceCommon.hpp"
 #include "Tip3Config.hpp"
 #include "Tip3Creds.hpp"
+#include "Tip3TransferCosts.hpp"
 #include "bind_info.hpp"
 #include "immutable_ids.hpp"
 
@@ -50,6 +66,12 @@ namespace tvm {
 static constexpr unsigned TOKEN_WALLET_TIMESTAMP_DELAY = 1800;
 using wallet_replay_protection_t = replay_attack_protection::timestamp<TOKEN_WALLET_TIMESTAMP_DELAY>;
 
+static constexpr unsigned TOKEN_WALLET_BURST_WINDOW   = 120;
+static constexpr unsigned TOKEN_WALLET_BURST_MAX_MSGS = 256;
+/// Replay protection of TONTokenWalletBurst (accepts bursts of messages in any arrival order)
+using wallet_burst_replay_protection_t =
+  replay_attack_protection::msg_hash_set<TOKEN_WALLET_BURST_WINDOW, TOKEN_WALLET_BURST_MAX_MSGS>;
+
 /// Complex key for lend owners mapping
 struct lend_owner_key {
   addr_std_fixed dest;    ///< Destination contract address.
@@ -60,10 +82,19 @@ struct lend_owner {
   uint128 lend_balance;     ///< Lend ownership balance.
   uint32  lend_finish_time; ///< Lend ownership finish time.
   uint256 user_pubkey;      ///< Lend pubkey of the user ordered to lend ownership to the address
+  uint256 binding_hash;     ///< Hash of the wallet binding the address was verified with (as PriceXchg of the bound Flex)
 };
 /// Lend owners (contracts) map
 using lend_owners_map = small_dict_map<lend_owner_key, lend_owner>;
 
+/// Owner notification policy flags (FlexWallet).
+struct wallet_notify_policy {
+  static constexpr unsigned notify_all       = 0; ///< Notify owner about every incoming transfer with payload
+  static constexpr unsigned skip_settlements = 1; ///< Don't notify owner about settlement transfers
+                                                  ///<  (sent by a verified wallet on behalf of its lend owner, i.e. PriceXchg deals,
+                                                  ///<  if the lend owner was verified with the same binding as the receiver has)
+};
+
 /// Lend ownership array record (for usage in getter).
 struct lend_owner_array_record {
   lend_owner_key lend_key;         ///< Lend ownership key (destination address + user id).
@@ -75,11 +106,15 @@ using lend_owners_array = dict_array<lend_owner_array_record>;
 
 /// TONTokenWallet details info (for getter).
 struct details_info {
+#ifndef TIP3_ENABLE_LEND_OWNERSHIP
   string            name;              ///< Token name.
   string            symbol;            ///< Token short symbol.
   uint8             decimals;          ///< Decimals for ui purposes. ex: balance 100 with decimals 2 will be printed as 1.00.
+#endif // TIP3_ENABLE_LEND_OWNERSHIP
   uint128           balance;           ///< Token balance of the wallet.
+#ifndef TIP3_ENABLE_LEND_OWNERSHIP
   uint256           root_pubkey;       ///< Public key of the related RootTokenContract.
+#endif // TIP3_ENABLE_LEND_OWNERSHIP
   address           root_address;      ///< Address of the related RootTokenContract.
   uint256           wallet_pubkey;     ///< Public key of wallet owner (User id for FlexWallet).
   address_opt       owner_address;     ///< Owner contract address for internal ownership, will be 0:0..0 otherwise.
@@ -124,6 +159,22 @@ __interface ITONTokenWalletNotify {
     cell           payload,       ///< Payload (arbitrary cell).
     address        answer_addr    ///< Answer address (to receive answer and the remaining processing evers).
   ) = 202;
+
+  /// Notification from FlexWallet (v2 identity) to its owner contract about received tokens transfer.
+  /// The same as onTip3Transfer, but FlexWallet doesn't keep display metadata, so only tip3 root address is reported.
+  [[internal, answer_id]]
+  bool onFlexTip3Transfer(
+    uint128        balance,       ///< New balance of the wallet.
+    uint128        new_tokens,    ///< Amount of tokens received in transfer.
+    uint128        evers_balance, ///< Evers balance of the wallet
+    address        tip3_root,     ///< Address of the related tip3 root (Wrapper).
+    opt<Tip3Creds> sender,        ///< Sender wallet's credentials (pubkey + owner). Empty if mint received from root/wrapper.
+    Tip3Creds      receiver,      ///< Receiver wallet's credentials (pubkey + owner).
+    opt<uint256>   lend_pubkey,   ///< Current lend pubkey of the wallet.
+    opt<bind_info> binding,       ///< Current binding of the wallet.
+    cell           payload,       ///< Payload (arbitrary cell).
+    address        answer_addr    ///< Answer address (to receive answer and the remaining processing evers).
+  ) = 203;
 };
 using ITONTokenWalletNotifyPtr = handle<ITONTokenWalletNotify>;
 
@@ -180,15 +231,18 @@ __interface ITONTokenWallet {
   ) = 0x4384F298;
 
   /// Receive tokens from another tip3 wallet.
+  /// Has a new id since `settlement` was added (v1 acceptTransfer without it had id 0x67A0B95F).
   [[internal]]
   void acceptTransfer(
-    uint128     _value,        ///< Amount of tokens received from another tip3 token wallet.
-    address     answer_addr,   ///< Answer address.
-    uint128     keep_evers,    ///< Native funds that the wallet should keep before returning answer with the remaining funds.
-    uint256     sender_pubkey, ///< Sender wallet pubkey.
-    address_opt sender_owner,  ///< Sender wallet internal owner.
-    opt<cell>   payload        ///< Payload (arbitrary cell). If specified, the wallet should send notification to its internal owner.
-  ) = 0x67A0B95F;
+    uint128      _value,        ///< Amount of tokens received from another tip3 token wallet.
+    address      answer_addr,   ///< Answer address.
+    uint128      keep_evers,    ///< Native funds that the wallet should keep before returning answer with the remaining funds.
+    uint256      sender_pubkey, ///< Sender wallet pubkey.
+    address_opt  sender_owner,  ///< Sender wallet internal owner.
+    opt<cell>    payload,       ///< Payload (arbitrary cell). If specified, the wallet should send notification to its internal owner.
+    opt<uint256> settlement     ///< If transfer is initiated by lend owner of the sender wallet (order settlement) -
+                                ///<  hash of the wallet binding the lend owner was verified with.
+  ) = 24;
 
 #ifdef TIP3_ENABLE_DESTROY
   /// Send the remaining !native! funds to \p dest and destroy the wallet.
@@ -267,15 +321,25 @@ __interface ITONTokenWallet {
     uint128 tokens ///< Amount of tokens to return.
   ) = 18;
 
+  /// Order is finished in PriceXchg: return ownership (for the provided amount of tokens)
+  ///  and accept the remaining order evers. Fused replacement for returnOwnership + IPriceCallback::onOrderFinished.
+  [[internal]]
+  void onOrderFinishedReturn(
+    OrderRet ret,          ///< Order finish notification details.
+    uint128  return_tokens ///< Amount of tokens to return.
+  ) = 23;
+
   /// set_binding - Set trade binding to allow orders only to flex root \p flex.
   /// And PriceXchg unsalted code hash must be equal to \p unsalted_price_code_hash.
   /// set_trader - Set lend ownership pubkey for external access
+  /// notify_policy - Set owner notification policy (wallet_notify_policy flags)
   [[internal]]
   void bind(
-    bool             set_binding, ///< Set binding
-    opt<bind_info>   binding,     ///< If `set_binding` is true, binding will be set
-    bool             set_trader,  ///< Set trader
-    opt<uint256>     trader       ///< If `set_trader` is true, trader (lend pubkey) will be set
+    bool             set_binding,  ///< Set binding
+    opt<bind_info>   binding,      ///< If `set_binding` is true, binding will be set
+    bool             set_trader,   ///< Set trader
+    opt<uint256>     trader,       ///< If `set_trader` is true, trader (lend pubkey) will be set
+    opt<uint8>       notify_policy ///< If specified, owner notification policy will be set
   ) = 19;
 #endif // TIP3_ENABLE_LEND_OWNERSHIP
 
@@ -298,11 +362,15 @@ using ITONTokenWalletPtr = handle<ITONTokenWallet>;
 
 /// TONTokenWallet persistent data struct
 struct DTONTokenWallet {
+#ifndef TIP3_ENABLE_LEND_OWNERSHIP
   string           name_;          ///< Token name.
   string           symbol_;        ///< Token short symbol.
   uint8            decimals_;      ///< Decimals for ui purposes. ex: balance 100 with decimals 2 will be printed as 1.00.
+#endif // TIP3_ENABLE_LEND_OWNERSHIP
   uint128          balance_;       ///< Token balance of the wallet.
+#ifndef TIP3_ENABLE_LEND_OWNERSHIP
   uint256          root_pubkey_;   ///< Public key of the related RootTokenContract.
+#endif // TIP3_ENABLE_LEND_OWNERSHIP
   address          root_address_;  ///< Address of the related RootTokenContract.
   uint256          wallet_pubkey_; ///< Public key of wallet owner.
   address_opt      owner_address_; ///< Owner contract address for internal ownership.
@@ -311,6 +379,7 @@ struct DTONTokenWallet {
   lend_owners_map  lend_owners_;   ///< Lend ownership map (service owner => lend_owner).
   opt<bind_info>   binding_;       ///< Binding to allow trade orders only to specific flex root
                                    ///<  and with specific unsalted PriceXchg code hash.
+  uint8            notify_policy_; ///< Owner notification policy (wallet_notify_policy flags).
 #endif // TIP3_ENABLE_LEND_OWNERSHIP
   uint256 code_hash_;              ///< Tip3 wallet code hash to verify other wallets.
   uint16  code_depth_;             ///< Tip3 wallet code depth to verify other wallets.
@@ -331,12 +400,9 @@ struct DTONTokenWalletExternal {
   int8        workchain_id_;      ///< Workchain id.
 };
 
+/// FlexWallet (v2) persistent data struct, without display metadata
 struct DTONTokenWalletInternal {
-  string       name_;            ///< Token name.
-  string       symbol_;          ///< Token short symbol.
-  uint8        decimals_;        ///< Decimals for ui purposes. ex: balance 100 with decimals 2 will be printed as 1.00.
   uint128      balance_;         ///< Token balance of the wallet.
-  uint256      root_pubkey_;     ///< Public key of the related RootTokenContract.
   address      root_address_;    ///< Address of the related RootTokenContract.
   uint256      wallet_pubkey_;   ///< Public key of wallet owner.
   address_opt  owner_address_;   ///< Owner contract address for internal ownership.
@@ -344,6 +410,7 @@ struct DTONTokenWalletInternal {
   lend_owners_map lend_owners_;  ///< Lend ownership map (service owner => lend_owner).
   opt<bind_info>  binding_;      ///< Binding info to allow trade orders only to specific flex root
                                  ///<  and with specific unsalted PriceXchg code hash.
+  uint8           notify_policy_; ///< Owner notification policy (wallet_notify_policy flags).
   uint256         code_hash_;    ///< Tip3 wallet code hash to verify other wallets.
   uint16          code_depth_;   ///< Tip3 wallet code depth to verify other wallets.
   int8            workchain_id_; ///< Workchain id.
@@ -355,19 +422,23 @@ struct ETONTokenWallet {
 };
 
 /// Prepare TONTokenWallet persistent data struct
+/// For FlexWallet (TIP3_ENABLE_LEND_OWNERSHIP) display metadata is ignored.
 inline
 DTONTokenWallet prepare_wallet_data(
-  string name, string symbol, uint8 decimals,
-  uint256 root_pubkey, address root_address,
+  [[maybe_unused]] string name, [[maybe_unused]] string symbol, [[maybe_unused]] uint8 decimals,
+  [[maybe_unused]] uint256 root_pubkey, address root_address,
   uint256 wallet_pubkey, address_opt wallet_owner,
   uint256 code_hash, uint16 code_depth, int8 workchain_id
 ) {
   return {
+#ifdef TIP3_ENABLE_LEND_OWNERSHIP
+    uint128(0), root_address,
+    wallet_pubkey, wallet_owner,
+    {}, {}, {}, {},
+#else
     name, symbol, decimals,
     uint128(0), root_pubkey, root_address,
     wallet_pubkey, wallet_owner,
-#ifdef TIP3_ENABLE_LEND_OWNERSHIP
-    {}, {}, {},
 #endif
     code_hash, code_depth,
     workchain_id
@@ -392,6 +463,7 @@ uint256 calc_wallet_init_hash(
 
 /// Calculate wallet original StateInit hash (to get its deploy address).
 /// For external wallets.
+template<class ReplayProtection = wallet_replay_protection_t>
 __always_inline
 uint256 calc_ext_wallet_init_hash(
   string name, string symbol, uint8 decimals,
@@ -403,22 +475,21 @@ uint256 calc_ext_wallet_init_hash(
     uint128(0), root_pubkey, root_address, wallet_pubkey, wallet_owner,
     code_hash, code_depth, workchain_id
   };
-  auto init_hdr = persistent_data_header<ITONTokenWallet, wallet_replay_protection_t>::init();
-  cell data_cl = prepare_persistent_data<ITONTokenWallet, wallet_replay_protection_t>(init_hdr, wallet_data);
+  auto init_hdr = persistent_data_header<ITONTokenWallet, ReplayProtection>::init();
+  cell data_cl = prepare_persistent_data<ITONTokenWallet, ReplayProtection>(init_hdr, wallet_data);
   return tvm_state_init_hash(code_hash, uint256(tvm_hash(data_cl)), code_depth, uint16(data_cl.cdepth()));
 }
 
 /// Calculate wallet original StateInit hash (to get its deploy address).
-/// For internal (flex) wallets.
+/// For internal (flex) wallets. Only \p tip3cfg.root_address is used (v2 identity).
 __always_inline
 uint256 calc_int_wallet_init_hash(
   Tip3Config tip3cfg, uint256 wallet_pubkey, address_opt wallet_owner,
   uint256 code_hash, uint16 code_depth, int8 workchain_id
 ) {
   DTONTokenWalletInternal wallet_data {
-    tip3cfg.name, tip3cfg.symbol, tip3cfg.decimals,
-    uint128(0), tip3cfg.root_pubkey, tip3cfg.root_address, wallet_pubkey, wallet_owner,
-    {}, {}, {}, code_hash, code_depth, workchain_id
+    uint128(0), tip3cfg.root_address, wallet_pubkey, wallet_owner,
+    {}, {}, {}, {}, code_hash, code_depth, workchain_id
   };
   auto init_hdr = persistent_data_header<ITONTokenWallet, wallet_replay_protection_t>::init();
   cell data_cl = prepare_persistent_data<ITONTokenWallet, wallet_replay_protection_t>(init_hdr, wallet_data);
@@ -427,11 +498,12 @@ uint256 calc_int_wallet_init_hash(
 
 /// Prepare Token Wallet StateInit structure and expected contract address (hash from StateInit).
 /// This version depends on macroses configuration (external / internal wallet).
+template<class ReplayProtection = wallet_replay_protection_t>
 inline
 std::pair<StateInit, uint256> prepare_wallet_state_init_and_addr(DTONTokenWallet wallet_data, cell code) {
-  auto init_hdr = persistent_data_header<ITONTokenWallet, wallet_replay_protection_t>::init();
+  auto init_hdr = persistent_data_header<ITONTokenWallet, ReplayProtection>::init();
   cell wallet_data_cl =
-    prepare_persistent_data<ITONTokenWallet, wallet_replay_protection_t>(init_hdr, wallet_data);
+    prepare_persistent_data<ITONTokenWallet, ReplayProtection>(init_hdr, wallet_data);
   StateInit wallet_init {
     /*split_depth*/{}, /*special*/{},
     code, wallet_data_cl, /*library*/{}
@@ -442,6 +514,7 @@ std::pair<StateInit, uint256> prepare_wallet_state_init_and_addr(DTONTokenWallet
 
 /// Prepare Token Wallet StateInit structure and expected contract address (hash from StateInit).
 /// For external wallets.
+template<class ReplayProtection = wallet_replay_protection_t>
 inline
 std::pair<StateInit, uint256> prepare_external_wallet_state_init_and_addr(
   string name, string symbol, uint8 decimals,
@@ -456,8 +529,8 @@ std::pair<StateInit, uint256> prepare_external_wallet_state_init_and_addr(
     code_hash, code_depth, workchain_id
   };
   cell wallet_data_cl =
-    prepare_persistent_data<ITONTokenWallet, wallet_replay_protection_t, DTONTokenWalletExternal>(
-      wallet_replay_protection_t::init(), wallet_data);
+    prepare_persistent_data<ITONTokenWallet, ReplayProtection, DTONTokenWalletExternal>(
+      ReplayProtection::init(), wallet_data);
   StateInit wallet_init {
     /*split_depth*/{}, /*special*/{},
     code, wallet_data_cl, /*library*/{}
@@ -467,19 +540,17 @@ std::pair<StateInit, uint256> prepare_external_wallet_state_init_and_addr(
 }
 
 /// Prepare Token Wallet StateInit structure and expected contract address (hash from StateInit).
-/// For internal wallets.
+/// For internal wallets (v2 identity).
 inline
 std::pair<StateInit, uint256> prepare_internal_wallet_state_init_and_addr(
-  string name, string symbol, uint8 decimals,
-  uint256 root_pubkey, address root_address,
+  address root_address,
   uint256 wallet_pubkey, address_opt wallet_owner,
   uint256 code_hash, uint16 code_depth,
   int8 workchain_id, cell code
 ) {
   DTONTokenWalletInternal wallet_data {
-    name, symbol, decimals,
-    uint128(0), root_pubkey, root_address, wallet_pubkey, wallet_owner,
-    {}, {}, {}, code_hash, code_depth, workchain_id
+    uint128(0), root_address, wallet_pubkey, wallet_owner,
+    {}, {}, {}, {}, code_hash, code_depth, workchain_id
   };
   cell wallet_data_cl =
     prepare_persistent_data<ITONTokenWallet, wallet_replay_protection_t, DTONTokenWalletInternal>(
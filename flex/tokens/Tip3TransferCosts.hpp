@@ -0,0 +1,15 @@
+/** \file
+ *  \brief Tip3 wallet transfer costs
+ *
+ *  \author Andrew Zhogin
+ *  \copyright 2019-2022 (c) EverFlex Inc
+ */
+
+#pragma once
+
+namespace tvm {
+
+/// Minimum transfer costs in evers, checked by tip3 wallet (TONTokenWallet / FlexWallet) for a transfer
+static constexpr unsigned tip3_min_transfer_costs = 150000000;
+
+} // namespace tvm
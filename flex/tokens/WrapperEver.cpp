@@ -237,8 +237,7 @@ private:
                                                           address_opt owner_addr) {
     auto [wallet_init, dest_addr] =
       prepare_internal_wallet_state_init_and_addr(
-        name_, symbol_, decimals_,
-        root_pubkey_, address{tvm_myaddr()},
+        address{tvm_myaddr()},
         pubkey, owner_addr,
         uint256(internal_wallet_hash), uint16(internal_wallet_code_depth),
         workchain_id_, internal_wallet_code_.get());
@@ -10,6 +10,7 @@
 #include "UserIdIndex.hpp"
 #include "AuthIndex.hpp"
 #include "UserDataConfig.hpp"
+#include "gas_profile.hpp"
 
 #include <tvm/contract.hpp>
 #include <tvm/smart_switcher.hpp>
@@ -20,15 +21,20 @@
 
 using namespace tvm;
 
-static constexpr unsigned TIMESTAMP_DELAY = 1800;
-
 /// FlexClient contract. Implements IFlexClient.
+/// \p ReplayProtection must be the same as in FlexClientStub (its replay state is passed in onCodeUpgrade).
+template<class ReplayProtection = flex_client_replay_protection_t>
 class FlexClient final : public smart_interface<IFlexClient>, public DFlexClient {
   using data = DFlexClient;
 public:
-  using replay_protection_t = replay_attack_protection::timestamp<TIMESTAMP_DELAY>;
+  using replay_protection_t = ReplayProtection;
   DEFAULT_SUPPORT_FUNCTIONS(IFlexClient, replay_protection_t)
 
+  /// Maximum cached lend pubkeys (user ids)
+  static constexpr unsigned lend_pubkeys_cache_max = 32;
+  /// Cached lend pubkey lifetime (in seconds)
+  static constexpr unsigned lend_pubkeys_cache_ttl = 3600;
+
   struct error_code : tvm::error_code {
     static constexpr unsigned message_sender_is_not_my_owner = 100; ///< Message sender is not my owner
     static constexpr unsigned zero_num_in_price              = 101; ///< Zero numerator in price
@@ -138,6 +144,7 @@ public:
     require(price_num != 0, error_code::zero_num_in_price);
     tvm_accept();
     tvm_commit();
+    FLEX_GAS_CHECKPOINT(client_order_entry);
 
     FlexLendPayloadArgs args = {
       .sell                = sell,
@@ -152,9 +159,11 @@ public:
     ITONTokenWalletPtr my_tip3(my_tip3_addr);
     my_tip3(Evers(evers.get())).
       makeOrder(address{tvm_myaddr()}, 0u128, lend_amount, lend_finish_time, price_num, unsalted_price_code, price_salt, args);
+    FLEX_GAS_CHECKPOINT(client_order_sent);
 
     auto [state_init, addr, std_addr] = preparePriceXchg(price_num, tvm_add_code_salt_cell(price_salt, unsalted_price_code));
     auto price_addr = IPriceXchgPtr(addr);
+    FLEX_GAS_CHECKPOINT(client_order_done);
     return price_addr.get();
   }
 
@@ -171,14 +180,14 @@ public:
     auto workchain_id = std::get<addr_std>(tvm_myaddr().val()).workchain_id;
 
     auto [init, hash_addr] = prepare_internal_wallet_state_init_and_addr(
-      tip3cfg.name, tip3cfg.symbol, tip3cfg.decimals,
-      tip3cfg.root_pubkey, tip3cfg.root_address,
+      tip3cfg.root_address,
       pubkey, address{tvm_myaddr()},
       uint256(tvm_hash(flex_wallet_code)), uint16(flex_wallet_code.cdepth()),
       workchain_id, flex_wallet_code
       );
     ITONTokenWalletPtr new_wallet(address::make_std(workchain_id, hash_addr));
-    new_wallet.deploy(init, Evers(evers_to_wallet.get())).bind(true, binding_, true, trader);
+    new_wallet.deploy(init, Evers(evers_to_wallet.get())).
+      bind(true, binding_, true, trader, uint8(wallet_notify_policy::skip_settlements));
     return new_wallet.get();
   }
 
@@ -212,18 +221,20 @@ public:
     uint128             evers_relend_call,
     uint128             evers_each_wallet_call,
     uint128             evers_to_remove,
-    uint128             evers_to_auth_idx
+    uint128             evers_to_auth_idx,
+    opt<uint8>          notify_policy
   ) {
     require(msg_pubkey() == owner_, error_code::message_sender_is_not_my_owner);
     tvm_accept();
     tvm_commit();
     require(wallets.size() < (255 / 2), error_code::too_many_wallets);
+    lend_pubkeys_.erase(user_id);
     if (set_trader && trader) {
       IUserIdIndexPtr(getUserIdIndex(user_id))(Evers(evers_relend_call.get())).
         reLendPubkey(*trader, evers_to_remove, evers_to_auth_idx);
     }
     for (auto addr : wallets) {
-      ITONTokenWalletPtr(addr)(Evers(evers_each_wallet_call.get())).bind(set_binding, binding, set_trader, trader);
+      ITONTokenWalletPtr(addr)(Evers(evers_each_wallet_call.get())).bind(set_binding, binding, set_trader, trader, notify_policy);
     }
   }
 
@@ -233,6 +244,7 @@ public:
   ) {
     require(msg_pubkey() == owner_, error_code::message_sender_is_not_my_owner);
     tvm_accept();
+    lend_pubkeys_.erase(user_id);
     tvm_commit();
     IUserIdIndexPtr(getUserIdIndex(user_id))(Evers(evers.get())).remove();
   }
@@ -379,7 +391,8 @@ public:
     bool           set_binding,
     opt<bind_info> binding,
     bool           set_trader,
-    opt<uint256>   trader
+    opt<uint256>   trader,
+    opt<uint8>     notify_policy
   ) {
     require(msg_pubkey() == owner_, error_code::message_sender_is_not_my_owner);
     tvm_accept();
@@ -387,38 +400,68 @@ public:
 
     ITONTokenWalletPtr my_tip3(my_tip3_addr);
     my_tip3(Evers(evers.get())).
-      bind(set_binding, binding, set_trader, trader);
+      bind(set_binding, binding, set_trader, trader, notify_policy);
   }
 
-  /// Implementation of ITONTokenWalletNotify::onTip3Transfer.
-  /// Notification from tip3 wallet to its owner contract about received tokens transfer.
-  resumable<void> onTip3Transfer(
+  /// Implementation of ITONTokenWalletNotify::onFlexTip3Transfer.
+  /// Notification from flex tip3 wallet to its owner contract about received tokens transfer.
+  resumable<void> onFlexTip3Transfer(
     [[maybe_unused]] uint128        balance,
     [[maybe_unused]] uint128        new_tokens,
                      uint128        evers_balance,
-                     Tip3Config     tip3cfg,
+                     address        tip3_root,
                      opt<Tip3Creds> sender,
                      Tip3Creds      receiver,
+                     opt<uint256>   lend_pubkey,
+                     opt<bind_info> binding,
     [[maybe_unused]] cell           payload,
-    [[maybe_unused]] address        answer_addr
+                     address        answer_addr
   ) {
     require(user_id_index_code_, error_code::uninitialized);
     auto workchain_id = std::get<addr_std>(tvm_myaddr().val()).workchain_id;
     auto expected_hash = calc_int_wallet_init_hash(
-      tip3cfg, receiver.pubkey, receiver.owner,
+      Tip3Config{.root_address = tip3_root}, receiver.pubkey, receiver.owner,
       uint256(TIP3_WALLET_CODE_HASH), uint16(TIP3_WALLET_CODE_DEPTH), workchain_id
       );
     require(int_sender() == address::make_std(workchain_id, expected_hash), error_code::unverified_tip3_wallet);
     tvm_accept();
 
+    ITONTokenWalletPtr wallet(address::make_std(workchain_id, expected_hash));
     auto user_id = receiver.pubkey;
+    // Known lend pubkey - without UserIdIndex request, the refill is paid from FlexClient balance
+    if (auto cached = lend_pubkeys_.lookup(user_id); cached && cached->expire_at > tvm_now()) {
+      auto refill = calc_wallet_refill(cached->refill_wallet, cached->min_refill, evers_balance);
+      if (tvm_balance() - int_value().get() > refill.get()) {
+        tvm_rawreserve(tvm_balance() - int_value().get() - refill.get(), rawreserve_flag::up_to);
+        if (!is_wallet_bound(lend_pubkey, binding, cached->lend_pubkey)) {
+          // Settlements will not be notified anymore, only deposits
+          wallet(0_ev, SEND_ALL_GAS).bind(true, binding_, true, cached->lend_pubkey, uint8(wallet_notify_policy::skip_settlements));
+        } else if (refill != 0) {
+          // Only the refill
+          tvm_transfer(wallet.get(), 0, false, SEND_ALL_GAS);
+        } else {
+          // Nothing to change in the wallet, the remaining evers are returned to the original caller
+          set_int_sender(answer_addr);
+          set_int_return_value(0);
+          set_int_return_flag(SEND_ALL_GAS);
+        }
+        co_return;
+      }
+    }
     auto salted_code = tvm_add_code_salt(UserIdIndexSalt{tvm_myaddr(), auth_index_code_.get()}, user_id_index_code_.get());
     [[maybe_unused]] auto [init, hash] = prepare<IUserIdIndex>(DUserIdIndex{.user_id_ = user_id}, salted_code);
     IUserIdIndexPtr ptr(address::make_std(workchain_id, hash));
-    auto lend_pubkey = co_await ptr(_remaining_ev()).requestLendPubkey(evers_balance);
+    // UserIdIndex attaches the refill evers to the answer
+    auto info = co_await ptr(_remaining_ev()).requestLendInfo(evers_balance);
+    cache_lend_info(user_id, info);
 
-    ITONTokenWalletPtr wallet(address::make_std(workchain_id, expected_hash));
-    wallet(_remaining_ev()).bind(true, binding_, true, lend_pubkey);
+    if (is_wallet_bound(lend_pubkey, binding, info.lend_pubkey)) {
+      // Only the refill
+      tvm_transfer(wallet.get(), 0, false, SEND_ALL_GAS);
+    } else {
+      // Settlements will not be notified anymore, only deposits
+      wallet(_remaining_ev()).bind(true, binding_, true, info.lend_pubkey, uint8(wallet_notify_policy::skip_settlements));
+    }
   }
 
   cell getPayloadForDeployInternalWallet(
@@ -470,6 +513,24 @@ public:
   }
 
 private:
+  /// Wallet already has \p expected_lend_pubkey and the current FlexClient binding
+  bool is_wallet_bound(opt<uint256> lend_pubkey, opt<bind_info> binding, uint256 expected_lend_pubkey) const {
+    if (!lend_pubkey || *lend_pubkey != expected_lend_pubkey)
+      return false;
+    if (!binding || !binding_)
+      return !binding && !binding_;
+    return binding->flex == binding_->flex && binding->unsalted_price_code_hash == binding_->unsalted_price_code_hash;
+  }
+
+  /// Cache lend info of \p user_id. The cache is bounded, when it is full, the lowest user id is evicted.
+  void cache_lend_info(uint256 user_id, UserIdLendInfo info) {
+    if (!lend_pubkeys_.contains(user_id) && lend_pubkeys_.size() >= lend_pubkeys_cache_max)
+      lend_pubkeys_.erase((*lend_pubkeys_.begin()).first);
+    lend_pubkeys_.set_at(user_id, {
+      info.lend_pubkey, info.refill_wallet, info.min_refill, uint32(tvm_now() + lend_pubkeys_cache_ttl)
+    });
+  }
+
   std::tuple<StateInit, address, uint256> preparePriceXchg(
       uint128 price_num, cell price_code) const {
 
@@ -478,7 +539,8 @@ private:
       .sells_amount_ = 0u128,
       .buys_amount_  = 0u128,
       .sells_        = {},
-      .buys_         = {}
+      .buys_         = {},
+      .stats_        = {}
     };
     auto workchain_id = std::get<addr_std>(tvm_myaddr().val()).workchain_id;
     auto [state_init, std_addr] = prepare<IPriceXchg>(price_data, price_code);
@@ -487,7 +549,12 @@ private:
   }
 };
 
-DEFINE_JSON_ABI(IFlexClient, DFlexClient, EFlexClient, FlexClient::replay_protection_t);
-
 // ----------------------------- Main entry functions ---------------------- //
-DEFAULT_MAIN_ENTRY_FUNCTIONS(FlexClient, IFlexClient, DFlexClient, TIMESTAMP_DELAY)
+#ifdef FLEX_CLIENT_BURST
+using FlexClientBurst = FlexClient<flex_client_burst_replay_protection_t>;
+DEFINE_JSON_ABI(IFlexClient, DFlexClient, EFlexClient, flex_client_burst_replay_protection_t);
+MAIN_ENTRY_FUNCTIONS_REPLAY(FlexClientBurst, IFlexClient, DFlexClient, flex_client_burst_replay_protection_t)
+#else
+DEFINE_JSON_ABI(IFlexClient, DFlexClient, EFlexClient, flex_client_replay_protection_t);
+DEFAULT_MAIN_ENTRY_FUNCTIONS(FlexClient<>, IFlexClient, DFlexClient, FLEX_CLIENT_TIMESTAMP_DELAY)
+#endif
@@ -9,6 +9,7 @@
 #include <tvm/schema/message.hpp>
 #include <tvm/smart_switcher.hpp>
 #include <tvm/contract_handle.hpp>
+#include <tvm/small_dict_map.hpp>
 
 #include "PriceXchg.hpp"
 #include "FlexVersion.hpp"
@@ -29,6 +30,18 @@ struct FlexClientDetails {
   cell             user_id_index_code; ///< UserIdIndex code
 };
 
+/// Cached lend info of a user id (from UserIdIndex::requestLendInfo)
+struct lend_pubkey_cache_entry {
+  uint256 lend_pubkey;   ///< Lend pubkey of the user id
+  uint128 refill_wallet; ///< UserIdIndex re-fill wallet value
+  uint128 min_refill;    ///< UserIdIndex minimum refill value
+  uint32  expire_at;     ///< The entry is re-requested after this time (to catch up UserIdIndex::setRefillWallet changes)
+};
+
+/// Cached lend info (user_id => lend info), to skip UserIdIndex request in onFlexTip3Transfer (refill is sent from FlexClient balance).
+/// Binding is not a part of the key because `binding_` is changed only in upgrade (with a fresh data).
+using lend_pubkeys_cache = small_dict_map<uint256, lend_pubkey_cache_entry>;
+
 /// Burn parameters for each wallet in `burnThemAll`
 struct BurnInfo {
   uint256     out_pubkey; ///< Public key for external wallet (out)
@@ -115,7 +128,7 @@ __interface IFlexClient {
   ) = 15;
 
   /// Change lend_pubkey into UserIdIndex contract(call UserIdIndex.reLendPubkey) if set_trader & trader.
-  /// Call bind(set_binding, binding, set_trader, trader) for every wallet from wallets.
+  /// Call bind(set_binding, binding, set_trader, trader, notify_policy) for every wallet from wallets.
   [[external]]
   void reBindWallets(
     uint256             user_id,                ///< User id
@@ -127,7 +140,8 @@ __interface IFlexClient {
     uint128             evers_relend_call,      ///< Evers for `UserIdIndex->reLendPubkey` call
     uint128             evers_each_wallet_call, ///< Evers for each `FlexWallet->lendOwnershipPubkey` call
     uint128             evers_to_remove,        ///< Evers to send in `AuthIndex->remove` call inside `UserIdIndex->reLendPubkey`
-    uint128             evers_to_auth_idx       ///< Evers to send in new AuthIndex deploy call inside `UserIdIndex->reLendPubkey`
+    uint128             evers_to_auth_idx,      ///< Evers to send in new AuthIndex deploy call inside `UserIdIndex->reLendPubkey`
+    opt<uint8>          notify_policy           ///< If specified, owner notification policy (wallet_notify_policy) will be set into wallets
   ) = 16;
 
   /// Remove UserIdIndex contract
@@ -191,22 +205,25 @@ __interface IFlexClient {
     bool           set_binding,  ///< Set binding
     opt<bind_info> binding,      ///< if `set_binding` is true, binding will be set
     bool           set_trader,   ///< Set trader
-    opt<uint256>   trader        ///< if `set_trader` is true, trader (lend pubkey) will be set
+    opt<uint256>   trader,       ///< if `set_trader` is true, trader (lend pubkey) will be set
+    opt<uint8>     notify_policy ///< if specified, owner notification policy (wallet_notify_policy) will be set
   ) = 22;
 
-  /// Implementation of ITONTokenWalletNotify::onTip3Transfer.
-  /// Notification from tip3 wallet to its owner contract about received tokens transfer.
+  /// Implementation of ITONTokenWalletNotify::onFlexTip3Transfer.
+  /// Notification from flex tip3 wallet to its owner contract about received tokens transfer.
   [[internal, answer_id]]
-  resumable<void> onTip3Transfer(
+  resumable<void> onFlexTip3Transfer(
     uint128        balance,       ///< New balance of the wallet.
     uint128        new_tokens,    ///< Amount of tokens received in transfer.
     uint128        evers_balance, ///< Evers balance of the wallet.
-    Tip3Config     tip3cfg,       ///< Tip3 config.
+    address        tip3_root,     ///< Address of the related tip3 root (Wrapper).
     opt<Tip3Creds> sender,        ///< Sender wallet's credentials (pubkey + owner). Empty if mint received from root/wrapper.
     Tip3Creds      receiver,      ///< Receiver wallet's credentials (pubkey + owner).
+    opt<uint256>   lend_pubkey,   ///< Current lend pubkey of the wallet.
+    opt<bind_info> binding,       ///< Current binding of the wallet.
     cell           payload,       ///< Payload (must be FlexTransferPayloadArgs).
     address        answer_addr    ///< Answer address (to receive answer and the remaining processing evers).
-  ) = 202;
+  ) = 203;
 
   /// Upgrade FlexClient to the specific UserDataConfig
   [[external]]
@@ -265,6 +282,7 @@ struct DFlexClient1 {
   bool_t               packet_canceling_;   ///< When cancelThemAll was postponed into continueCancelThemAll call
   uint128              cancel_ev_;          ///< Processing evers for each wallet `cancelOrder` call
   dict_array<address>  prices_;             ///< Array of PriceXchg addresses
+  lend_pubkeys_cache   lend_pubkeys_;       ///< Cached lend pubkeys of user ids (invalidated in reBindWallets/destroyIndex)
 };
 
 using DFlexClient = DFlexClient1;
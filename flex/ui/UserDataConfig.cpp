@@ -10,6 +10,8 @@
 
 using namespace tvm;
 
+/// \p FlexClientReplayProtection is the replay protection of the deployed FlexClientStub (for its address)
+template<class FlexClientReplayProtection = flex_client_replay_protection_t>
 class UserDataConfig final : public smart_interface<IUserDataConfig>, public DUserDataConfig {
   using data = DUserDataConfig;
 public:
@@ -43,7 +45,7 @@ public:
 
     auto workchain_id = std::get<addr_std>(tvm_myaddr().val()).workchain_id;
     DFlexClientStub data {.owner_ = pubkey};
-    auto [init, hash] = prepare<IFlexClientStub>(data, flex_client_stub_.get());
+    auto [init, hash] = prepare_flex_client_stub<FlexClientReplayProtection>(data, flex_client_stub_.get());
     IFlexClientStubPtr ptr(address::make_std(workchain_id, hash));
 
     tvm_rawreserve(tvm_balance() - int_value().get(), rawreserve_flag::up_to);
@@ -63,7 +65,7 @@ public:
     require(initialized(), error_code::uninitialized);
     auto workchain_id = std::get<addr_std>(tvm_myaddr().val()).workchain_id;
     DFlexClientStub data {.owner_ = pubkey};
-    [[maybe_unused]] auto [init, hash] = prepare<IFlexClientStub>(data, flex_client_stub_.get());
+    [[maybe_unused]] auto [init, hash] = prepare_flex_client_stub<FlexClientReplayProtection>(data, flex_client_stub_.get());
     return address::make_std(workchain_id, hash);
   }
 
@@ -72,6 +74,19 @@ public:
     return { triplet_, *binding_, flex_client_stub_.get(), flex_client_code_.get(), auth_index_code_.get(), user_id_index_code_.get() };
   }
 
+  optcell getCodeByHash(uint256 code_hash) {
+    require(initialized(), error_code::uninitialized);
+    if (uint256(tvm_hash(flex_client_stub_.get())) == code_hash)
+      return flex_client_stub_.get();
+    if (uint256(tvm_hash(flex_client_code_.get())) == code_hash)
+      return flex_client_code_.get();
+    if (uint256(tvm_hash(auth_index_code_.get())) == code_hash)
+      return auth_index_code_.get();
+    if (uint256(tvm_hash(user_id_index_code_.get())) == code_hash)
+      return user_id_index_code_.get();
+    return {};
+  }
+
   UserDataConfigSalt getConfig() {
     return parse_chain_static<UserDataConfigSalt>(parser(tvm_code_salt()));
   }
@@ -97,4 +112,10 @@ public:
 DEFINE_JSON_ABI(IUserDataConfig, DUserDataConfig, EUserDataConfig);
 
 // ----------------------------- Main entry functions ---------------------- //
-MAIN_ENTRY_FUNCTIONS_NO_REPLAY(UserDataConfig, IUserDataConfig, DUserDataConfig)
+#ifdef FLEX_CLIENT_BURST
+// Deploys FlexClientStubBurst stubs
+using UserDataConfigBurst = UserDataConfig<flex_client_burst_replay_protection_t>;
+MAIN_ENTRY_FUNCTIONS_NO_REPLAY(UserDataConfigBurst, IUserDataConfig, DUserDataConfig)
+#else
+MAIN_ENTRY_FUNCTIONS_NO_REPLAY(UserDataConfig<>, IUserDataConfig, DUserDataConfig)
+#endif
@@ -64,6 +64,11 @@ __interface IUserDataConfig {
   [[getter]]
   UserDataConfigDetails getDetails();
 
+  /// Get one of the code cells (FlexClientStub, FlexClient, AuthIndex, UserIdIndex) by its hash.
+  /// For clients checking code cache with SuperRoot::getBootstrap hashes.
+  [[getter]]
+  optcell getCodeByHash(uint256 code_hash);
+
   /// Get config from code salt
   [[getter]]
   UserDataConfigSalt getConfig();
@@ -65,9 +65,13 @@ public:
 
   uint256 requestLendPubkey(uint128 evers_balance) {
     require(int_sender() == getConfig().owner, error_code::message_sender_is_not_my_owner);
-    int refill_val = static_cast<int>(refill_wallet_.get()) - static_cast<int>(evers_balance.get());
-    refill_val = std::max(static_cast<int>(min_refill_.get()), refill_val);
-    return _fixed_ev(uint128(static_cast<unsigned>(refill_val))) & lend_pubkey_;
+    return _fixed_ev(calc_wallet_refill(refill_wallet_, min_refill_, evers_balance)) & lend_pubkey_;
+  }
+
+  UserIdLendInfo requestLendInfo(uint128 evers_balance) {
+    require(int_sender() == getConfig().owner, error_code::message_sender_is_not_my_owner);
+    return _fixed_ev(calc_wallet_refill(refill_wallet_, min_refill_, evers_balance)) &
+      UserIdLendInfo{lend_pubkey_, refill_wallet_, min_refill_};
   }
 
   void transfer(address dest, uint128 value, bool bounce) {
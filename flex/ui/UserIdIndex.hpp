@@ -22,6 +22,21 @@ struct UserIdIndexSalt {
   cell    auth_index_code; ///< Code of AuthIndex (no salt)
 };
 
+/// Lend pubkey with wallet refill parameters (answer of IUserIdIndex::requestLendInfo)
+struct UserIdLendInfo {
+  uint256 lend_pubkey;   ///< Lend public key (current app pubkey)
+  uint128 refill_wallet; ///< Re-fill wallet on transfer received
+  uint128 min_refill;    ///< Minimum refill value
+};
+
+/// Evers to re-fill the wallet with \p evers_balance on transfer received
+__always_inline
+uint128 calc_wallet_refill(uint128 refill_wallet, uint128 min_refill, uint128 evers_balance) {
+  int refill_val = static_cast<int>(refill_wallet.get()) - static_cast<int>(evers_balance.get());
+  refill_val = std::max(static_cast<int>(min_refill.get()), refill_val);
+  return uint128(static_cast<unsigned>(refill_val));
+}
+
 /** \interface IUserIdIndex
  *  \brief UserIdIndex contract interface.
  *  There is no way to understand which wallets were created for some FlexClient. So we need UserID Index for it.
@@ -77,6 +92,13 @@ __interface IUserIdIndex {
   /// Get config from code salt
   [[getter]]
   UserIdIndexSalt getConfig() = 16;
+
+  /// Request lend pubkey with refill parameters (to be cached by FlexClient).
+  /// Re-fills the wallet the same way as requestLendPubkey.
+  [[internal, answer_id]]
+  UserIdLendInfo requestLendInfo(
+    uint128 evers_balance ///< Evers balance of the wallet
+    ) = 17;
 };
 using IUserIdIndexPtr = handle<IUserIdIndex>;
 